@@ -0,0 +1,163 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/arrow_export.h"
+
+#include <memory>
+#include <utility>
+
+namespace dingodb {
+
+// Owned by ArrowSchema::private_data, one per node.
+struct ArrowSchemaHolder {
+  std::string format;
+  std::string name;
+  std::vector<std::unique_ptr<ArrowSchema>> children;
+  std::vector<ArrowSchema*> child_pointers;
+};
+
+// Owned by ArrowArray::private_data, one per node. Every node keeps the batch alive, a consumer may move children
+// out and release them after the parent.
+struct ArrowArrayHolder {
+  std::shared_ptr<ColumnBatch> batch;
+  std::vector<const void*> buffers;
+  std::vector<std::unique_ptr<ArrowArray>> children;
+  std::vector<ArrowArray*> child_pointers;
+};
+
+static void ReleaseSchema(ArrowSchema* schema) {
+  auto* holder = static_cast<ArrowSchemaHolder*>(schema->private_data);
+  for (ArrowSchema* child : holder->child_pointers) {
+    if (child->release != nullptr) {
+      child->release(child);
+    }
+  }
+  delete holder;
+  schema->release = nullptr;
+}
+
+static void ReleaseArray(ArrowArray* array) {
+  auto* holder = static_cast<ArrowArrayHolder*>(array->private_data);
+  for (ArrowArray* child : holder->child_pointers) {
+    if (child->release != nullptr) {
+      child->release(child);
+    }
+  }
+  delete holder;
+  array->release = nullptr;
+}
+
+static void InitSchema(std::string format, std::string name, int64_t flags, ArrowSchemaHolder* holder,
+                       ArrowSchema* schema) {
+  holder->format = std::move(format);
+  holder->name = std::move(name);
+  for (auto& child : holder->children) {
+    holder->child_pointers.push_back(child.get());
+  }
+  schema->format = holder->format.c_str();
+  schema->name = holder->name.c_str();
+  schema->metadata = nullptr;
+  schema->flags = flags;
+  schema->n_children = holder->child_pointers.size();
+  schema->children = holder->child_pointers.data();
+  schema->dictionary = nullptr;
+  schema->release = ReleaseSchema;
+  schema->private_data = holder;
+}
+
+static void InitArray(int64_t length, int64_t null_count, ArrowArrayHolder* holder, ArrowArray* array) {
+  for (auto& child : holder->children) {
+    holder->child_pointers.push_back(child.get());
+  }
+  array->length = length;
+  array->null_count = null_count;
+  array->offset = 0;
+  array->n_buffers = holder->buffers.size();
+  array->n_children = holder->child_pointers.size();
+  array->buffers = holder->buffers.data();
+  array->children = holder->child_pointers.data();
+  array->dictionary = nullptr;
+  array->release = ReleaseArray;
+  array->private_data = holder;
+}
+
+static void ExportColumnSchema(const ColumnVector& column, const std::string& name, int64_t flags,
+                               ArrowSchema* schema) {
+  auto* holder = new ArrowSchemaHolder();
+  if (column.child != nullptr) {
+    holder->children.push_back(std::make_unique<ArrowSchema>());
+    ExportColumnSchema(*column.child, "item", 0, holder->children.back().get());
+  }
+  InitSchema(ArrowFormat(column.type), name, flags, holder, schema);
+}
+
+static void ExportColumnArray(const std::shared_ptr<ColumnBatch>& batch, const ColumnVector& column,
+                              ArrowArray* array) {
+  auto* holder = new ArrowArrayHolder();
+  holder->batch = batch;
+  holder->buffers.push_back(column.null_count > 0 ? column.validity.data() : nullptr);
+  if (!column.offsets.empty()) {
+    holder->buffers.push_back(column.offsets.data());
+  }
+  if (column.child == nullptr) {
+    holder->buffers.push_back(column.data.data());
+  } else {
+    holder->children.push_back(std::make_unique<ArrowArray>());
+    ExportColumnArray(batch, *column.child, holder->children.back().get());
+  }
+  InitArray(column.size, column.null_count, holder, array);
+}
+
+const char* ArrowFormat(BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kBool:
+      return "b";
+    case BaseSchema::kInteger:
+      return "i";
+    case BaseSchema::kFloat:
+      return "f";
+    case BaseSchema::kLong:
+      return "l";
+    case BaseSchema::kDouble:
+      return "g";
+    case BaseSchema::kString:
+      return "u";
+    default:
+      return "+l";
+  }
+}
+
+int ExportArrow(ColumnBatch&& batch, const std::vector<std::string>& names, ArrowSchema* schema, ArrowArray* array) {
+  if (names.size() != batch.columns.size()) {
+    return -1;
+  }
+  auto owned = std::make_shared<ColumnBatch>(std::move(batch));
+
+  auto* schema_holder = new ArrowSchemaHolder();
+  auto* array_holder = new ArrowArrayHolder();
+  array_holder->batch = owned;
+  // A struct has no nulls, its only buffer is the absent validity bitmap.
+  array_holder->buffers.push_back(nullptr);
+  for (size_t i = 0; i < owned->columns.size(); i++) {
+    schema_holder->children.push_back(std::make_unique<ArrowSchema>());
+    ExportColumnSchema(owned->columns[i], names[i], ARROW_FLAG_NULLABLE, schema_holder->children.back().get());
+    array_holder->children.push_back(std::make_unique<ArrowArray>());
+    ExportColumnArray(owned, owned->columns[i], array_holder->children.back().get());
+  }
+  InitSchema("+s", "", 0, schema_holder, schema);
+  InitArray(owned->num_rows, 0, array_holder, array);
+  return 0;
+}
+
+}  // namespace dingodb
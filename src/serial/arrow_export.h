@@ -0,0 +1,39 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_ARROW_EXPORT_H_
+#define DINGO_SERIAL_ARROW_EXPORT_H_
+
+#include <string>
+#include <vector>
+
+#include "serial/arrow_c_data.h"
+#include "serial/column_batch.h"
+
+namespace dingodb {
+
+// Arrow format string of a column type: b, i, f, l, g, u for the scalars and strings, +l over the element type for
+// the lists.
+const char* ArrowFormat(BaseSchema::Type type);
+
+// Hand batch over to an Arrow consumer as a struct array with one field per column, named by names. The buffers are
+// those of batch, which is moved into the exported array and lives until the consumer releases it (or the last child
+// it moved out), nothing is copied. Both outputs are released independently by the consumer. Returns -1 if names
+// does not match the columns.
+int ExportArrow(ColumnBatch&& batch, const std::vector<std::string>& names, ArrowSchema* schema /*output*/,
+                ArrowArray* array /*output*/);
+
+}  // namespace dingodb
+
+#endif
@@ -18,17 +18,26 @@
 #include <cstdint>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "serial/buf_view.h"
+
 namespace dingodb {
 
-class Buf {
+// Growable encode buffer. Encoded bytes are written forward from the head and
+// backward from the tail; the read cursors are inherited from BufView.
+//
+// A Buf may also wrap caller-owned memory, in which case bytes are written in
+// place. Such a Buf only falls back to an owned copy if it runs out of room.
+class Buf : public BufView {
  private:
   std::string buf_;
-  int forward_pos_ = 0;
-  int reverse_pos_ = 0;
+  // Write target, either buf_ or caller-owned memory.
+  char* base_ = nullptr;
   int count_ = 0;
-  bool le_;
+
+  void Attach();
 
  public:
   Buf(int size, bool le);
@@ -37,40 +46,55 @@ class Buf {
   Buf(std::string* buf);
   Buf(const std::string& buf, bool le);
   Buf(const std::string& buf);
+  // Writes into the size bytes at data, which must outlive the Buf.
+  Buf(char* data, int size, bool le);
+  // Takes over storage as the owned buffer, keeping its capacity. See Release.
+  Buf(std::string&& storage, int size, bool le);
   ~Buf();
   void Init(int size);
   void Init(std::string* buf);
   void Init(const std::string& buf);
-  void SetForwardPos(int fp);
-  void SetReversePos(int rp);
   void Write(uint8_t b);
   void WriteWithNegation(uint8_t b);
-  void Write(const std::string& data);
+  void Write(std::string_view data);
   void WriteInt(int32_t i);
   void WriteLong(int64_t l);
   void WriteLongWithNegation(int64_t l);
   void ReverseWrite(uint8_t b);
   void ReverseWriteInt(int32_t i);
 
-  uint8_t Peek();
-  int32_t PeekInt();
-  int64_t PeekLong();
+  // Byte order resolved at compile time, see byte_order.h.
+  template <bool LE>
+  void WriteInt(int32_t i) {
+    StoreUint32<LE>(&base_[forward_pos_], i);
+    forward_pos_ += 4;
+  }
+
+  template <bool LE>
+  void WriteLong(int64_t l) {
+    StoreUint64<LE>(&base_[forward_pos_], l);
+    forward_pos_ += 8;
+  }
+
+  template <bool LE>
+  void WriteLongWithNegation(int64_t l) {
+    WriteLong<LE>(~l);
+  }
+
+  template <bool LE>
+  void ReverseWriteInt(int32_t i) {
+    reverse_pos_ -= 4;
+    StoreUint32<!LE>(&base_[reverse_pos_ + 1], i);
+  }
 
-  uint8_t Read();
-  int32_t ReadInt();
-  int64_t ReadLong();
-  std::string ReadString();
-  uint8_t ReverseRead();
-  int32_t ReverseReadInt();
-  void ReverseSkipInt();
-  void Skip(int size);
-  void ReverseSkip(int size);
   void EnsureRemainder(int length);
+  // True when the bytes are still in caller-owned memory and fill it exactly.
+  bool IsFilled(const char* data) const;
   std::string* GetBytes();
   int GetBytes(std::string& s);
   std::string GetString();
-  bool IsLe() const;
-  bool IsEnd() const;
+  // Hands the owned buffer back for reuse, the Buf must not be used afterwards.
+  std::string Release();
 };
 
 }  // namespace dingodb
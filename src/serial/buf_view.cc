@@ -0,0 +1,112 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/buf_view.h"
+
+#include "serial/utils.h"
+
+namespace dingodb {
+
+BufView::BufView(bool le) : le_(le) {}
+
+BufView::BufView(const char* data, int size, bool le)
+    : data_(data), size_(size), forward_pos_(0), reverse_pos_(size - 1), le_(le) {}
+
+BufView::BufView(const char* data, int size) : BufView(data, size, IsLE()) {}
+
+BufView::BufView(std::string_view buf, bool le) : BufView(buf.data(), buf.size(), le) {}
+
+BufView::BufView(std::string_view buf) : BufView(buf.data(), buf.size(), IsLE()) {}
+
+void BufView::SetForwardPos(int fp) { this->forward_pos_ = fp; }
+
+void BufView::SetReversePos(int rp) { this->reverse_pos_ = rp; }
+
+int BufView::GetForwardPos() const { return this->forward_pos_; }
+
+int BufView::GetReversePos() const { return this->reverse_pos_; }
+
+uint8_t BufView::Peek() { return data_[forward_pos_]; }
+
+int32_t BufView::PeekInt() { return le_ ? PeekInt<true>() : PeekInt<false>(); }
+
+int64_t BufView::PeekLong() { return le_ ? PeekLong<true>() : PeekLong<false>(); }
+
+uint8_t BufView::Read() { return data_[forward_pos_++]; }
+
+int32_t BufView::ReadInt() { return le_ ? ReadInt<true>() : ReadInt<false>(); }
+
+int64_t BufView::ReadLong() { return le_ ? ReadLong<true>() : ReadLong<false>(); }
+
+std::string BufView::ReadString() {
+  int internal_forward_pos = forward_pos_;
+  forward_pos_ = size_;
+  return std::string(data_ + internal_forward_pos, size_ - internal_forward_pos);
+}
+
+uint8_t BufView::ReverseRead() { return data_[reverse_pos_--]; }
+
+int32_t BufView::ReverseReadInt() { return le_ ? ReverseReadInt<true>() : ReverseReadInt<false>(); }
+
+void BufView::ReverseSkipInt() { reverse_pos_ -= 4; }
+
+void BufView::Skip(int size) { forward_pos_ += size; }
+
+void BufView::ReverseSkip(int size) { reverse_pos_ -= size; }
+
+int BufView::Remainder() const { return size_ - forward_pos_; }
+
+bool BufView::CheckRemainder(int64_t size) {
+  if (size < 0 || size > Remainder()) {
+    SetCorrupt();
+    return false;
+  }
+  return true;
+}
+
+bool BufView::CheckReverseRemainder(int size) {
+  if (size < 0 || size > reverse_pos_ + 1) {
+    SetCorrupt();
+    return false;
+  }
+  return true;
+}
+
+int BufView::ReadLength(int width) {
+  if (!CheckRemainder(4)) {
+    return -1;
+  }
+  int length = ReadInt();
+  if (!CheckRemainder(static_cast<int64_t>(length) * width)) {
+    return -1;
+  }
+  return length;
+}
+
+void BufView::SetCorrupt() {
+  corrupt_ = true;
+  forward_pos_ = reverse_pos_ + 1;
+}
+
+bool BufView::IsCorrupt() const { return this->corrupt_; }
+
+const char* BufView::Data() const { return this->data_; }
+
+int BufView::Size() const { return this->size_; }
+
+bool BufView::IsLe() const { return this->le_; }
+
+bool BufView::IsEnd() const { return (reverse_pos_ - forward_pos_ + 1) == 0; }
+
+}  // namespace dingodb
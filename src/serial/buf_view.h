@@ -0,0 +1,118 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_BUF_VIEW_H_
+#define DINGO_SERIAL_BUF_VIEW_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "serial/byte_order.h"
+
+namespace dingodb {
+
+// Read-only, non-owning cursor over encoded bytes. The forward cursor starts at
+// the first byte and the reverse cursor at the last one, mirroring Buf. The
+// referenced memory must outlive the view.
+class BufView {
+ protected:
+  const char* data_ = nullptr;
+  int size_ = 0;
+  int forward_pos_ = 0;
+  int reverse_pos_ = -1;
+  bool le_;
+  bool corrupt_ = false;
+
+  explicit BufView(bool le);
+
+ public:
+  BufView(const char* data, int size, bool le);
+  BufView(const char* data, int size);
+  BufView(std::string_view buf, bool le);
+  BufView(std::string_view buf);
+  ~BufView() = default;
+
+  void SetForwardPos(int fp);
+  void SetReversePos(int rp);
+  int GetForwardPos() const;
+  int GetReversePos() const;
+
+  uint8_t Peek();
+  int32_t PeekInt();
+  int64_t PeekLong();
+
+  uint8_t Read();
+  int32_t ReadInt();
+  int64_t ReadLong();
+  std::string ReadString();
+  uint8_t ReverseRead();
+  int32_t ReverseReadInt();
+  void ReverseSkipInt();
+  void Skip(int size);
+  void ReverseSkip(int size);
+
+  // The raw reads above do not check bounds. Lengths stored in the bytes are checked here before anything is read
+  // through them, forward against the end of the view and reverse against its start. A claim past either marks the
+  // view corrupt and moves the forward cursor to the reverse one, so later value columns read as null and the
+  // decoder returns -1.
+  int Remainder() const;
+  bool CheckRemainder(int64_t size);
+  bool CheckReverseRemainder(int size);
+  // Length prefix of a string or list whose elements take width bytes each, -1 if they would run past the end.
+  int ReadLength(int width);
+  void SetCorrupt();
+  bool IsCorrupt() const;
+
+  // Byte order resolved at compile time, see byte_order.h.
+  template <bool LE>
+  int32_t PeekInt() {
+    return LoadUint32<LE>(data_ + forward_pos_);
+  }
+
+  template <bool LE>
+  int64_t PeekLong() {
+    return LoadUint64<LE>(data_ + forward_pos_);
+  }
+
+  template <bool LE>
+  int32_t ReadInt() {
+    int32_t i = LoadUint32<LE>(data_ + forward_pos_);
+    forward_pos_ += 4;
+    return i;
+  }
+
+  template <bool LE>
+  int64_t ReadLong() {
+    int64_t l = LoadUint64<LE>(data_ + forward_pos_);
+    forward_pos_ += 8;
+    return l;
+  }
+
+  // Reverse ints are stored mirrored, ReverseRead() yields the first forward byte.
+  template <bool LE>
+  int32_t ReverseReadInt() {
+    reverse_pos_ -= 4;
+    return LoadUint32<!LE>(data_ + reverse_pos_ + 1);
+  }
+
+  const char* Data() const;
+  int Size() const;
+  bool IsLe() const;
+  bool IsEnd() const;
+};
+
+}  // namespace dingodb
+
+#endif
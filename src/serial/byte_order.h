@@ -0,0 +1,75 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_BYTE_ORDER_H_
+#define DINGO_SERIAL_BYTE_ORDER_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace dingodb {
+
+// Fixed width fields are laid out by the codec `le` flag, not by the host:
+// with LE == true the most significant byte is stored first, with LE == false
+// the least significant byte is stored first. Each access is a single memcpy
+// plus at most one byte swap.
+
+constexpr bool kHostLE = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+template <bool LE>
+inline void StoreUint32(char* p, uint32_t v) {
+  if constexpr (LE == kHostLE) {
+    v = __builtin_bswap32(v);
+  }
+  memcpy(p, &v, 4);
+}
+
+template <bool LE>
+inline void StoreUint64(char* p, uint64_t v) {
+  if constexpr (LE == kHostLE) {
+    v = __builtin_bswap64(v);
+  }
+  memcpy(p, &v, 8);
+}
+
+template <bool LE>
+inline uint32_t LoadUint32(const char* p) {
+  uint32_t v;
+  memcpy(&v, p, 4);
+  if constexpr (LE == kHostLE) {
+    v = __builtin_bswap32(v);
+  }
+  return v;
+}
+
+template <bool LE>
+inline uint64_t LoadUint64(const char* p) {
+  uint64_t v;
+  memcpy(&v, p, 8);
+  if constexpr (LE == kHostLE) {
+    v = __builtin_bswap64(v);
+  }
+  return v;
+}
+
+// Top bit of the first stored byte, flipped in memcomparable key encodings.
+template <bool LE>
+constexpr uint32_t kKeyFlip32 = LE ? 0x80000000U : 0x80U;
+
+template <bool LE>
+constexpr uint64_t kKeyFlip64 = LE ? 0x8000000000000000ULL : 0x80ULL;
+
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,41 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/codec_handle.h"
+
+#include <utility>
+
+namespace dingodb {
+
+CodecHandle::CodecHandle(std::shared_ptr<const RecordCodec> codec) : current_(std::move(codec)) {}
+
+std::shared_ptr<const RecordCodec> CodecHandle::Pin() const { return current_.Load(); }
+
+int CodecHandle::SchemaVersion() const { return current_.Load()->schema_version; }
+
+std::shared_ptr<const RecordCodec> CodecHandle::Swap(std::shared_ptr<const RecordCodec> codec) {
+  std::lock_guard<std::mutex> lock(update_mutex_);
+  return current_.Exchange(std::move(codec));
+}
+
+bool CodecHandle::Upgrade(std::shared_ptr<const RecordCodec> codec) {
+  std::lock_guard<std::mutex> lock(update_mutex_);
+  if (current_.Load()->schema_version >= codec->schema_version) {
+    return false;
+  }
+  current_.Store(std::move(codec));
+  return true;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,49 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_CODEC_HANDLE_H_
+#define DINGO_SERIAL_CODEC_HANDLE_H_
+
+#include <memory>
+#include <mutex>
+
+#include "serial/codec_registry.h"
+#include "serial/rcu_ptr.h"
+
+namespace dingodb {
+
+// Current codec of one table across schema changes. A scan or a write pins the codec it starts with and keeps it
+// for its whole duration, without locking. A schema change publishes the next codec without waiting for them, the
+// retired one is destroyed when its last pin is released.
+class CodecHandle {
+ private:
+  RcuPtr<const RecordCodec> current_;
+  std::mutex update_mutex_;
+
+ public:
+  explicit CodecHandle(std::shared_ptr<const RecordCodec> codec);
+
+  std::shared_ptr<const RecordCodec> Pin() const;
+  int SchemaVersion() const;
+
+  // Publish codec unconditionally, returns the codec it retires.
+  std::shared_ptr<const RecordCodec> Swap(std::shared_ptr<const RecordCodec> codec);
+  // Publish codec only if its schema version is newer than the current one, so racing DDL notifications cannot
+  // roll the table back. Returns whether codec was published.
+  bool Upgrade(std::shared_ptr<const RecordCodec> codec);
+};
+
+}  // namespace dingodb
+
+#endif
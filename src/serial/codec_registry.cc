@@ -0,0 +1,140 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/codec_registry.h"
+
+#include <functional>
+#include <utility>
+
+#include "serial/utils.h"
+
+namespace dingodb {
+
+RecordCodec::RecordCodec(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                         long common_id, bool le)
+    : schema_version(schema_version),
+      common_id(common_id),
+      encoder(schema_version, schemas, common_id, le),
+      decoder(schema_version, schemas, common_id, le) {}
+
+bool CodecRegistry::Key::operator==(const Key& other) const {
+  return common_id == other.common_id && schema_version == other.schema_version;
+}
+
+size_t CodecRegistry::KeyHash::operator()(const Key& key) const {
+  return std::hash<long>()(key.common_id) * 31 + std::hash<int>()(key.schema_version);
+}
+
+CodecRegistry::CodecRegistry(size_t capacity) : CodecRegistry(capacity, IsLE()) {}
+
+CodecRegistry::CodecRegistry(size_t capacity, bool le) : le_(le), capacity_(capacity) {
+  for (auto& shard : shards_) {
+    shard.Store(std::make_shared<const Shard>());
+  }
+}
+
+RcuPtr<const CodecRegistry::Shard>& CodecRegistry::ShardOf(const Key& key) {
+  return shards_[KeyHash()(key) % kShards];
+}
+
+const RcuPtr<const CodecRegistry::Shard>& CodecRegistry::ShardOf(const Key& key) const {
+  return shards_[KeyHash()(key) % kShards];
+}
+
+std::shared_ptr<const RecordCodec> CodecRegistry::Get(long common_id, int schema_version) const {
+  Key key{common_id, schema_version};
+  std::shared_ptr<const Shard> shard = ShardOf(key).Load();
+  auto it = shard->find(key);
+  if (it == shard->end()) {
+    return nullptr;
+  }
+  // Only write the bit when it changes, a hot codec then stays in every reader's cache.
+  if (!it->second->referenced.load(std::memory_order_relaxed)) {
+    it->second->referenced.store(true, std::memory_order_relaxed);
+  }
+  return it->second->codec;
+}
+
+std::shared_ptr<const RecordCodec> CodecRegistry::GetOrCreate(
+    long common_id, int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas) {
+  std::shared_ptr<const RecordCodec> codec = Get(common_id, schema_version);
+  if (codec != nullptr) {
+    return codec;
+  }
+
+  // Compile outside the lock, a racing insert of the same table wins and this one is dropped.
+  codec = std::make_shared<const RecordCodec>(schema_version, schemas, common_id, le_);
+  Key key{common_id, schema_version};
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  RcuPtr<const Shard>& shard = ShardOf(key);
+  std::shared_ptr<const Shard> current = shard.Load();
+  auto it = current->find(key);
+  if (it != current->end()) {
+    return it->second->codec;
+  }
+  auto next = std::make_shared<Shard>(*current);
+  auto entry = std::make_shared<Entry>();
+  entry->codec = codec;
+  next->emplace(key, entry);
+  shard.Store(std::move(next));
+  size_++;
+  if (size_ > capacity_) {
+    Evict();
+  }
+  return codec;
+}
+
+void CodecRegistry::Erase(long common_id, int schema_version) {
+  Key key{common_id, schema_version};
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  RcuPtr<const Shard>& shard = ShardOf(key);
+  std::shared_ptr<const Shard> current = shard.Load();
+  if (current->count(key) == 0) {
+    return;
+  }
+  auto next = std::make_shared<Shard>(*current);
+  next->erase(key);
+  shard.Store(std::move(next));
+  size_--;
+}
+
+void CodecRegistry::Evict() {
+  // Second chance: a referenced entry loses its bit and survives this sweep, an unreferenced one goes. Best effort:
+  // two rounds over the shards get back under capacity unless lookups set the bits again meanwhile, the registry may
+  // then stay above capacity until the sweep of a later insert.
+  for (int i = 0; i < 2 * kShards && size_ > capacity_; i++) {
+    RcuPtr<const Shard>& shard = shards_[clock_hand_];
+    clock_hand_ = (clock_hand_ + 1) % kShards;
+    std::shared_ptr<const Shard> current = shard.Load();
+    std::shared_ptr<Shard> next;
+    for (const auto& [key, entry] : *current) {
+      if (size_ > capacity_ && !entry->referenced.exchange(false, std::memory_order_relaxed)) {
+        if (next == nullptr) {
+          next = std::make_shared<Shard>(*current);
+        }
+        next->erase(key);
+        size_--;
+      }
+    }
+    if (next != nullptr) {
+      shard.Store(std::move(next));
+    }
+  }
+}
+
+size_t CodecRegistry::Size() const { return size_; }
+
+size_t CodecRegistry::Capacity() const { return capacity_; }
+
+}  // namespace dingodb
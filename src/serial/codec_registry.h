@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_CODEC_REGISTRY_H_
+#define DINGO_SERIAL_CODEC_REGISTRY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "serial/rcu_ptr.h"
+#include "serial/record_decoder.h"
+#include "serial/record_encoder.h"
+
+namespace dingodb {
+
+// Encoder and decoder of one table schema version, compiled once and shared read-only.
+struct RecordCodec {
+  RecordCodec(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id,
+              bool le);
+
+  const int schema_version;
+  const long common_id;
+  const RecordEncoder encoder;
+  const RecordDecoder decoder;
+};
+
+// Process wide intern table of compiled codecs, keyed by (common_id, schema_version). Lookups take no lock, they
+// read an immutable snapshot of one of the shards. Inserts and evictions copy that shard under a writer lock.
+// Beyond capacity, codecs not looked up since the previous sweep are evicted (CLOCK), a codec still held by a caller
+// stays alive until released.
+class CodecRegistry {
+ private:
+  static constexpr int kShards = 64;
+
+  struct Key {
+    long common_id;
+    int schema_version;
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    std::shared_ptr<const RecordCodec> codec;
+    // Set by lookups, cleared by the eviction sweep.
+    std::atomic<bool> referenced{true};
+  };
+
+  using Shard = std::unordered_map<Key, std::shared_ptr<Entry>, KeyHash>;
+
+  RcuPtr<const Shard>& ShardOf(const Key& key);
+  const RcuPtr<const Shard>& ShardOf(const Key& key) const;
+  void Evict();
+
+  bool le_;
+  size_t capacity_;
+  RcuPtr<const Shard> shards_[kShards];
+  std::atomic<size_t> size_{0};
+  std::mutex write_mutex_;
+  int clock_hand_ = 0;
+
+ public:
+  explicit CodecRegistry(size_t capacity);
+  CodecRegistry(size_t capacity, bool le);
+
+  // nullptr if the table version is not registered.
+  std::shared_ptr<const RecordCodec> Get(long common_id, int schema_version) const;
+  // The registered codec, compiled from schemas on first use.
+  std::shared_ptr<const RecordCodec> GetOrCreate(long common_id, int schema_version,
+                                                 std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas);
+  void Erase(long common_id, int schema_version);
+
+  size_t Size() const;
+  size_t Capacity() const;
+};
+
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,216 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/column_batch.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace dingodb {
+
+static BaseSchema::Type ElementType(BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kBoolList:
+      return BaseSchema::kBool;
+    case BaseSchema::kIntegerList:
+      return BaseSchema::kInteger;
+    case BaseSchema::kFloatList:
+      return BaseSchema::kFloat;
+    case BaseSchema::kLongList:
+      return BaseSchema::kLong;
+    case BaseSchema::kDoubleList:
+      return BaseSchema::kDouble;
+    default:
+      return BaseSchema::kString;
+  }
+}
+
+static bool IsList(BaseSchema::Type type) { return type >= BaseSchema::kBoolList; }
+
+static void SetBit(std::vector<uint8_t>& bits, int i, bool value) {
+  if (value) {
+    bits[i / 8] |= 1 << (i % 8);
+  } else {
+    bits[i / 8] &= ~(1 << (i % 8));
+  }
+}
+
+static bool GetBit(const std::vector<uint8_t>& bits, int i) { return bits[i / 8] >> (i % 8) & 1; }
+
+int ColumnVector::ValueWidth(BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kInteger:
+    case BaseSchema::kFloat:
+      return 4;
+    case BaseSchema::kLong:
+    case BaseSchema::kDouble:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+bool ColumnVector::IsFixedWidth(BaseSchema::Type type) { return type == BaseSchema::kBool || ValueWidth(type) > 0; }
+
+void ColumnVector::Reset(BaseSchema::Type type) {
+  this->type = type;
+  size = 0;
+  null_count = 0;
+  validity.clear();
+  data.clear();
+  offsets.clear();
+  if (!IsFixedWidth(type)) {
+    offsets.push_back(0);
+  }
+  if (IsList(type)) {
+    if (child == nullptr) {
+      child = std::make_unique<ColumnVector>();
+    }
+    child->Reset(ElementType(type));
+  } else {
+    child.reset();
+  }
+}
+
+void ColumnVector::Resize(int size) {
+  this->size = size;
+  null_count = size;
+  validity.assign((size + 7) / 8, 0);
+  if (type == BaseSchema::kBool) {
+    data.assign((size + 7) / 8, 0);
+  } else {
+    data.resize(static_cast<size_t>(size) * ValueWidth(type));
+  }
+}
+
+template <typename T>
+void ColumnVector::Set(int row, T value) {
+  if (!GetBit(validity, row)) {
+    SetBit(validity, row, true);
+    null_count--;
+  }
+  if constexpr (std::is_same_v<T, bool>) {
+    if (value) {
+      data[row / 8] |= 1 << (row % 8);
+    } else {
+      data[row / 8] &= ~(1 << (row % 8));
+    }
+  } else {
+    memcpy(data.data() + static_cast<size_t>(row) * sizeof(T), &value, sizeof(T));
+  }
+}
+
+template <typename T>
+void ColumnVector::Append(T value) {
+  int row = size++;
+  if (row % 8 == 0) {
+    validity.push_back(0);
+  }
+  SetBit(validity, row, true);
+  if constexpr (std::is_same_v<T, bool>) {
+    if (row % 8 == 0) {
+      data.push_back(0);
+    }
+    if (value) {
+      data[row / 8] |= 1 << (row % 8);
+    }
+  } else {
+    data.resize(data.size() + sizeof(T));
+    memcpy(data.data() + static_cast<size_t>(row) * sizeof(T), &value, sizeof(T));
+  }
+}
+
+void ColumnVector::AppendString(std::string_view value) {
+  int row = size++;
+  if (row % 8 == 0) {
+    validity.push_back(0);
+  }
+  SetBit(validity, row, true);
+  data.insert(data.end(), value.begin(), value.end());
+  offsets.push_back(data.size());
+}
+
+void ColumnVector::AppendList() {
+  int row = size++;
+  if (row % 8 == 0) {
+    validity.push_back(0);
+  }
+  SetBit(validity, row, true);
+  offsets.push_back(child->size);
+}
+
+void ColumnVector::AppendNull() {
+  int row = size++;
+  null_count++;
+  if (row % 8 == 0) {
+    validity.push_back(0);
+  }
+  if (type == BaseSchema::kBool) {
+    if (row % 8 == 0) {
+      data.push_back(0);
+    }
+  } else if (IsFixedWidth(type)) {
+    data.resize(data.size() + ValueWidth(type));
+  } else {
+    offsets.push_back(offsets.back());
+  }
+}
+
+bool ColumnVector::IsNull(int row) const { return !GetBit(validity, row); }
+
+template <typename T>
+T ColumnVector::Get(int row) const {
+  if constexpr (std::is_same_v<T, bool>) {
+    return data[row / 8] >> (row % 8) & 1;
+  } else {
+    T value;
+    memcpy(&value, data.data() + static_cast<size_t>(row) * sizeof(T), sizeof(T));
+    return value;
+  }
+}
+
+std::string_view ColumnVector::GetString(int row) const {
+  return std::string_view(data.data() + offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+int ColumnVector::GetListSize(int row) const { return offsets[row + 1] - offsets[row]; }
+
+int ColumnVector::GetListOffset(int row) const { return offsets[row]; }
+
+template void ColumnVector::Set<bool>(int row, bool value);
+template void ColumnVector::Set<int32_t>(int row, int32_t value);
+template void ColumnVector::Set<float>(int row, float value);
+template void ColumnVector::Set<int64_t>(int row, int64_t value);
+template void ColumnVector::Set<double>(int row, double value);
+template void ColumnVector::Append<bool>(bool value);
+template void ColumnVector::Append<int32_t>(int32_t value);
+template void ColumnVector::Append<float>(float value);
+template void ColumnVector::Append<int64_t>(int64_t value);
+template void ColumnVector::Append<double>(double value);
+template bool ColumnVector::Get<bool>(int row) const;
+template int32_t ColumnVector::Get<int32_t>(int row) const;
+template float ColumnVector::Get<float>(int row) const;
+template int64_t ColumnVector::Get<int64_t>(int row) const;
+template double ColumnVector::Get<double>(int row) const;
+
+int ColumnBatch::Size() const { return num_rows; }
+
+void ColumnBatch::Clear() {
+  for (auto& column : columns) {
+    column.Reset(column.type);
+  }
+  num_rows = 0;
+}
+
+}  // namespace dingodb
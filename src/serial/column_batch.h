@@ -0,0 +1,81 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_COLUMN_BATCH_H_
+#define DINGO_SERIAL_COLUMN_BATCH_H_
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {
+
+// One column of a batch in the Arrow memory layout. Bit i % 8 of validity[i / 8] is set when row i is not null.
+// Fixed width values sit back to back in data, bools bit packed like validity. Row i of a string or list column
+// spans [offsets[i], offsets[i + 1]) of the string bytes in data, or of the elements in child.
+struct ColumnVector {
+  BaseSchema::Type type = BaseSchema::kBool;
+  int size = 0;
+  int null_count = 0;
+  std::vector<uint8_t> validity;
+  std::vector<char> data;
+  std::vector<int32_t> offsets;
+  // Elements of a list column, never null.
+  std::unique_ptr<ColumnVector> child;
+
+  // Bytes per value of a fixed width type, 0 for bools, strings and lists.
+  static int ValueWidth(BaseSchema::Type type);
+  static bool IsFixedWidth(BaseSchema::Type type);
+
+  // No rows, keeping the capacity. A list column gets a child of its element type.
+  void Reset(BaseSchema::Type type);
+  // Fixed width columns only: size null rows, to be Set in any order.
+  void Resize(int size);
+  // T is bool, int32_t, float, int64_t or double, matching type.
+  template <typename T>
+  void Set(int row, T value);
+  // Rows are appended in order, this is the only way to fill strings and lists.
+  template <typename T>
+  void Append(T value);
+  void AppendString(std::string_view value);
+  // A list row made of the child elements appended since the previous row.
+  void AppendList();
+  void AppendNull();
+
+  bool IsNull(int row) const;
+  template <typename T>
+  T Get(int row) const;
+  std::string_view GetString(int row) const;
+  int GetListSize(int row) const;
+  // Row of child where the elements of list row row start.
+  int GetListOffset(int row) const;
+};
+
+// Decoded records as one ColumnVector per projected column, see RecordDecoder::DecodeBatch. Reusing one ColumnBatch
+// across batches keeps the buffer capacity.
+struct ColumnBatch {
+  std::vector<ColumnVector> columns;
+  int num_rows = 0;
+
+  int Size() const;
+  // No rows, keeping the columns and their capacity.
+  void Clear();
+};
+
+}  // namespace dingodb
+
+#endif
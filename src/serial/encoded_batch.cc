@@ -0,0 +1,36 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/encoded_batch.h"
+
+namespace dingodb {
+
+int EncodedBatch::Size() const { return key_offsets.empty() ? 0 : key_offsets.size() - 1; }
+
+std::string_view EncodedBatch::Key(int i) const {
+  return std::string_view(keys.data() + key_offsets[i], key_offsets[i + 1] - key_offsets[i]);
+}
+
+std::string_view EncodedBatch::Value(int i) const {
+  return std::string_view(values.data() + value_offsets[i], value_offsets[i + 1] - value_offsets[i]);
+}
+
+void EncodedBatch::Clear() {
+  keys.clear();
+  values.clear();
+  key_offsets.clear();
+  value_offsets.clear();
+}
+
+}  // namespace dingodb
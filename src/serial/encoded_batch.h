@@ -0,0 +1,44 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_ENCODED_BATCH_H_
+#define DINGO_SERIAL_ENCODED_BATCH_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dingodb {
+
+// Keys and values of a batch of records, each kind packed back to back into one arena. Record i's key is
+// keys[key_offsets[i], key_offsets[i + 1]) and likewise for its value, so the arenas can be handed to a write batch
+// as they are. Reusing one EncodedBatch across batches keeps the arena capacity.
+struct EncodedBatch {
+  std::string keys;
+  std::string values;
+  // Size() + 1 entries, starting at 0. 64 bit, an arena may outgrow an int while each record fits in one.
+  std::vector<int64_t> key_offsets;
+  std::vector<int64_t> value_offsets;
+
+  int Size() const;
+  std::string_view Key(int i) const;
+  std::string_view Value(int i) const;
+  // Empty, keeping the capacity.
+  void Clear();
+};
+
+}  // namespace dingodb
+
+#endif
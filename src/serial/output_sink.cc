@@ -0,0 +1,44 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/output_sink.h"
+
+namespace dingodb {
+
+StringSink::StringSink(std::string* output) : output_(output) {}
+
+char* StringSink::Reserve(int size) {
+  size_t offset = output_->size();
+  output_->resize(offset + size);
+  return output_->data() + offset;
+}
+
+void StringSink::Unreserve(int size) { output_->resize(output_->size() - size); }
+
+FixedSink::FixedSink(char* data, int capacity) : data_(data), capacity_(capacity) {}
+
+char* FixedSink::Reserve(int size) {
+  if (size > capacity_ - size_) {
+    return nullptr;
+  }
+  char* region = data_ + size_;
+  size_ += size;
+  return region;
+}
+
+void FixedSink::Unreserve(int size) { size_ -= size; }
+
+int FixedSink::Size() const { return this->size_; }
+
+}  // namespace dingodb
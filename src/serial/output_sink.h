@@ -0,0 +1,66 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_OUTPUT_SINK_H_
+#define DINGO_SERIAL_OUTPUT_SINK_H_
+
+#include <string>
+
+namespace dingodb {
+
+// Destination the encoders write into directly. The encoder asks for the exact
+// encoded length once and fills the returned region in place.
+//
+// To encode straight into a write batch, implement Reserve on top of the batch
+// representation, e.g. by growing its rep and returning the new tail.
+class OutputSink {
+ public:
+  virtual ~OutputSink() = default;
+
+  // Returns size writable bytes, or nullptr if the sink cannot hold them.
+  virtual char* Reserve(int size) = 0;
+  // Takes back the last size bytes handed out by Reserve, an encode that fails after reserving leaves the sink as it
+  // found it.
+  virtual void Unreserve(int size) = 0;
+};
+
+// Appends to an existing string, keeping its contents and capacity.
+class StringSink : public OutputSink {
+ private:
+  std::string* output_;
+
+ public:
+  explicit StringSink(std::string* output);
+  char* Reserve(int size) override;
+  void Unreserve(int size) override;
+};
+
+// Caller-owned fixed region, filled front to back.
+class FixedSink : public OutputSink {
+ private:
+  char* data_;
+  int capacity_;
+  int size_ = 0;
+
+ public:
+  FixedSink(char* data, int capacity);
+  char* Reserve(int size) override;
+  void Unreserve(int size) override;
+  // Bytes handed out so far.
+  int Size() const;
+};
+
+}  // namespace dingodb
+
+#endif
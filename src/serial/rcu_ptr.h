@@ -0,0 +1,83 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_RCU_PTR_H_
+#define DINGO_SERIAL_RCU_PTR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace dingodb {
+
+// Shared pointer read by many threads and replaced by few. Load takes no lock: a reader announces itself on the
+// counter of the current epoch for the few instructions it needs to copy the pointer. Exchange publishes the new
+// pointer, moves to the next epoch and waits for the readers of the previous one before it lets go of the old
+// pointer. A loaded pointer pins its object for as long as the caller holds it, so a replaced object is destroyed
+// once its last reader is done with it.
+template <typename T>
+class RcuPtr {
+ private:
+  std::atomic<std::shared_ptr<T>*> current_;
+  std::atomic<uint64_t> epoch_{0};
+  mutable std::atomic<int> readers_[2] = {0, 0};
+  std::mutex write_mutex_;
+
+ public:
+  RcuPtr() : current_(new std::shared_ptr<T>()) {}
+  explicit RcuPtr(std::shared_ptr<T> ptr) : current_(new std::shared_ptr<T>(std::move(ptr))) {}
+  ~RcuPtr() { delete current_.load(); }
+
+  RcuPtr(const RcuPtr&) = delete;
+  RcuPtr& operator=(const RcuPtr&) = delete;
+
+  std::shared_ptr<T> Load() const {
+    uint64_t epoch;
+    while (true) {
+      epoch = epoch_.load();
+      readers_[epoch & 1]++;
+      // A reader that saw the epoch only after a writer moved past it is not waited for, retry on the new counter.
+      if (epoch_.load() == epoch) {
+        break;
+      }
+      readers_[epoch & 1]--;
+    }
+    std::shared_ptr<T> ptr = *current_.load();
+    readers_[epoch & 1]--;
+    return ptr;
+  }
+
+  // Publish ptr and return the pointer it replaced.
+  std::shared_ptr<T> Exchange(std::shared_ptr<T> ptr) {
+    auto* next = new std::shared_ptr<T>(std::move(ptr));
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    std::shared_ptr<T>* previous = current_.exchange(next);
+    uint64_t epoch = epoch_++;
+    while (readers_[epoch & 1] != 0) {
+      std::this_thread::yield();
+    }
+    std::shared_ptr<T> replaced = std::move(*previous);
+    delete previous;
+    return replaced;
+  }
+
+  void Store(std::shared_ptr<T> ptr) { Exchange(std::move(ptr)); }
+};
+
+}  // namespace dingodb
+
+#endif
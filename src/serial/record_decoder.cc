@@ -14,56 +14,164 @@
 
 #include "serial/record_decoder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "serial/arrow_export.h"
+
 // #include "glog/logging.h"
 
 namespace dingodb {
 
-// TODO cast and decode function not good, optimize on 0.8.0 or later
+// Widest fixed width column, a nullable long or double.
+static constexpr int kMaxFixedLength = 9;
 
-using CastAndDecodeOrSkipFuncPointer = void (*)(const std::shared_ptr<BaseSchema>& schema, Buf& key_buf, Buf& value_buf,
-                                                std::vector<std::any>& record, int record_index, bool skip);
+// Fixed width columns have no length to check: one compare proves the widest fits, only a column near the end is
+// checked against its own width. Strings and lists check their lengths in the schemas, past a first byte for their
+// null tag or data.
+template <typename T>
+static bool CheckColumnLength(BaseSchema* schema, BufView& buf) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    return buf.Remainder() >= kMaxFixedLength || buf.CheckRemainder(schema->GetLength());
+  }
+  return buf.CheckRemainder(1);
+}
+
+template <typename T, bool LE>
+void DecodeKeyColumn(BaseSchema* schema, BufView& buf, std::any& column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if (!CheckColumnLength<T>(schema, buf)) {
+    column = std::optional<T>(std::nullopt);
+  } else if constexpr (kFixedKeyByteOrder<T>) {
+    column = dingo_schema->template DecodeKey<LE>(&buf);
+  } else {
+    column = dingo_schema->DecodeKey(&buf);
+  }
+}
+
+template <typename T, bool LE>
+void DecodeValueColumn(BaseSchema* schema, BufView& buf, std::any& column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if (buf.IsEnd() || !CheckColumnLength<T>(schema, buf)) {
+    column = std::optional<T>(std::nullopt);
+  } else if constexpr (kFixedValueByteOrder<T>) {
+    column = dingo_schema->template DecodeValue<LE>(&buf);
+  } else {
+    column = dingo_schema->DecodeValue(&buf);
+  }
+}
 
 template <typename T>
-void CastAndDecodeOrSkip(const std::shared_ptr<BaseSchema>& schema, Buf& key_buf, Buf& value_buf,
-                         std::vector<std::any>& record, int record_index, bool skip) {
-  auto dingo_schema = std::dynamic_pointer_cast<DingoSchema<std::optional<T>>>(schema);
-  if (skip) {
-    if (schema->IsKey()) {
-      dingo_schema->SkipKey(&key_buf);
-    } else if (!value_buf.IsEnd()) {
-      dingo_schema->SkipValue(&value_buf);
-    }
-  } else {
-    if (schema->IsKey()) {
-      record.at(record_index) = dingo_schema->DecodeKey(&key_buf);
+void SkipKeyColumn(BaseSchema* schema, BufView& buf) {
+  static_cast<DingoSchema<std::optional<T>>*>(schema)->SkipKey(&buf);
+}
+
+template <typename T>
+void SkipValueColumn(BaseSchema* schema, BufView& buf) {
+  if (!buf.IsEnd() && CheckColumnLength<T>(schema, buf)) {
+    static_cast<DingoSchema<std::optional<T>>*>(schema)->SkipValue(&buf);
+  }
+}
+
+// Scalar cells go through the optional overloads of the schemas, strings and lists through their row overloads.
+template <typename T, bool LE>
+void DecodeKeyCell(BaseSchema* schema, BufView& buf, Row& row, int column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if (!CheckColumnLength<T>(schema, buf)) {
+    row.SetNull(column);
+  } else if constexpr (std::is_same_v<T, std::shared_ptr<std::string>>) {
+    dingo_schema->DecodeKey(&buf, &row, column);
+  } else if constexpr (!std::is_arithmetic_v<T>) {
+    // Lists are never keys, the schema throws.
+    dingo_schema->DecodeKey(&buf);
+  } else if constexpr (kFixedKeyByteOrder<T>) {
+    row.SetScalar<T>(column, dingo_schema->template DecodeKey<LE>(&buf));
+  } else {
+    row.SetScalar<T>(column, dingo_schema->DecodeKey(&buf));
+  }
+}
+
+template <typename T, bool LE>
+void DecodeValueCell(BaseSchema* schema, BufView& buf, Row& row, int column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if (buf.IsEnd() || !CheckColumnLength<T>(schema, buf)) {
+    row.SetNull(column);
+  } else if constexpr (!std::is_arithmetic_v<T>) {
+    if constexpr (kFixedValueByteOrder<T>) {
+      dingo_schema->template DecodeValue<LE>(&buf, &row, column);
     } else {
-      if (value_buf.IsEnd()) {
-        record.at(record_index) = std::optional<T>(std::nullopt);
-      } else {
-        record.at(record_index) = dingo_schema->DecodeValue(&value_buf);
-      }
+      dingo_schema->DecodeValue(&buf, &row, column);
     }
+  } else if constexpr (kFixedValueByteOrder<T>) {
+    row.SetScalar<T>(column, dingo_schema->template DecodeValue<LE>(&buf));
+  } else {
+    row.SetScalar<T>(column, dingo_schema->DecodeValue(&buf));
   }
 }
 
-CastAndDecodeOrSkipFuncPointer cast_and_decode_or_skip_func_ptrs[] = {
-    CastAndDecodeOrSkip<bool>,
-    CastAndDecodeOrSkip<int32_t>,
-    CastAndDecodeOrSkip<float>,
-    CastAndDecodeOrSkip<int64_t>,
-    CastAndDecodeOrSkip<double>,
-    CastAndDecodeOrSkip<std::shared_ptr<std::string>>,
-    CastAndDecodeOrSkip<std::shared_ptr<std::vector<bool>>>,
-    CastAndDecodeOrSkip<std::shared_ptr<std::vector<int32_t>>>,
-    CastAndDecodeOrSkip<std::shared_ptr<std::vector<float>>>,
-    CastAndDecodeOrSkip<std::shared_ptr<std::vector<int64_t>>>,
-    CastAndDecodeOrSkip<std::shared_ptr<std::vector<double>>>,
-    CastAndDecodeOrSkip<std::shared_ptr<std::vector<std::string>>>,
-};
+template <typename T, bool LE>
+void BindColumn(ColumnDecoder& column) {
+  if (column.key) {
+    column.decode = DecodeKeyColumn<T, LE>;
+    column.skip = SkipKeyColumn<T>;
+    column.decode_row = DecodeKeyCell<T, LE>;
+  } else {
+    column.decode = DecodeValueColumn<T, LE>;
+    column.skip = SkipValueColumn<T>;
+    column.decode_row = DecodeValueCell<T, LE>;
+  }
+}
+
+template <bool LE>
+void BindColumn(ColumnDecoder& column, BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kBool:
+      BindColumn<bool, LE>(column);
+      break;
+    case BaseSchema::kInteger:
+      BindColumn<int32_t, LE>(column);
+      break;
+    case BaseSchema::kFloat:
+      BindColumn<float, LE>(column);
+      break;
+    case BaseSchema::kLong:
+      BindColumn<int64_t, LE>(column);
+      break;
+    case BaseSchema::kDouble:
+      BindColumn<double, LE>(column);
+      break;
+    case BaseSchema::kString:
+      BindColumn<std::shared_ptr<std::string>, LE>(column);
+      break;
+    case BaseSchema::kBoolList:
+      BindColumn<std::shared_ptr<std::vector<bool>>, LE>(column);
+      break;
+    case BaseSchema::kIntegerList:
+      BindColumn<std::shared_ptr<std::vector<int32_t>>, LE>(column);
+      break;
+    case BaseSchema::kFloatList:
+      BindColumn<std::shared_ptr<std::vector<float>>, LE>(column);
+      break;
+    case BaseSchema::kLongList:
+      BindColumn<std::shared_ptr<std::vector<int64_t>>, LE>(column);
+      break;
+    case BaseSchema::kDoubleList:
+      BindColumn<std::shared_ptr<std::vector<double>>, LE>(column);
+      break;
+    case BaseSchema::kStringList:
+      BindColumn<std::shared_ptr<std::vector<std::string>>, LE>(column);
+      break;
+  }
+}
 
 RecordDecoder::RecordDecoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
                              long common_id) {
@@ -80,18 +188,221 @@ RecordDecoder::RecordDecoder(int schema_version, std::shared_ptr<std::vector<std
 void RecordDecoder::Init(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
                          long common_id) {
   this->schema_version_ = schema_version;
-  FormatSchema(schemas, this->le_);
   this->schemas_ = schemas;
   this->common_id_ = common_id;
+  CompileProgram();
+  versions_.clear();
+  defaults_.assign(schemas->size(), std::any());
+  default_row_.Reset(schemas->size());
+}
+
+void RecordDecoder::SetThreadPool(std::shared_ptr<ThreadPool> pool, int min_parallel_rows) {
+  this->pool_ = pool;
+  this->min_parallel_rows_ = min_parallel_rows;
+}
+
+void RecordDecoder::CompileProgram() {
+  program_.clear();
+  key_program_.clear();
+  value_program_.clear();
+  locations_.assign(schemas_->size(), {false, -1});
+  int position = 0;
+  int ordinal = 0;
+  for (const auto& bs : *schemas_) {
+    if (bs) {
+      ColumnDecoder column{};
+      column.schema = bs.get();
+      column.position = position;
+      column.ordinal = ordinal++;
+      column.index = bs->GetIndex();
+      column.key = bs->IsKey();
+      column.fixed_value_length = !column.key && bs->GetType() <= BaseSchema::kDouble ? bs->GetLength() : -1;
+      if (le_) {
+        BindColumn<true>(column, bs->GetType());
+      } else {
+        BindColumn<false>(column, bs->GetType());
+      }
+      program_.push_back(column);
+      std::vector<ColumnDecoder>& stream = column.key ? key_program_ : value_program_;
+      if (column.index >= 0 && column.index < static_cast<int>(locations_.size())) {
+        locations_[column.index] = {column.key, static_cast<int>(stream.size())};
+      }
+      stream.push_back(column);
+    }
+    position++;
+  }
 }
 
-bool RecordDecoder::CheckPrefix(Buf& buf) const {
+int RecordDecoder::AddSchemaVersion(int schema_version,
+                                    std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas) {
+  if (schema_version >= schema_version_) {
+    //"Not An Older Schema Version"
+    return -1;
+  }
+  VersionPlan plan;
+  plan.schema_version = schema_version;
+  plan.schemas = schemas;
+  std::vector<bool> present(program_.size(), false);
+  for (const auto& bs : *schemas) {
+    if (!bs || bs->IsKey()) {
+      continue;
+    }
+    ColumnDecoder column{};
+    column.schema = bs.get();
+    column.position = -1;
+    column.ordinal = -1;
+    column.index = -1;
+    column.key = false;
+    column.fixed_value_length = bs->GetType() <= BaseSchema::kDouble ? bs->GetLength() : -1;
+    if (bs->GetIndex() >= 0) {
+      auto current = std::find_if(program_.begin(), program_.end(), [&bs](const ColumnDecoder& column) {
+        return !column.key && column.index == bs->GetIndex();
+      });
+      if (current == program_.end() || current->schema->GetType() != bs->GetType()) {
+        //"Column Does Not Match The Current Schemas"
+        return -1;
+      }
+      column.ordinal = current->ordinal;
+      column.index = current->index;
+      present[current->ordinal] = true;
+    }
+    if (le_) {
+      BindColumn<true>(column, bs->GetType());
+    } else {
+      BindColumn<false>(column, bs->GetType());
+    }
+    plan.value_program.push_back(column);
+  }
+  for (const auto& column : program_) {
+    if (!column.key && !present[column.ordinal]) {
+      plan.added.push_back(column.ordinal);
+    }
+  }
+  plan.value_positions.assign(schemas_->size(), -1);
+  for (size_t i = 0; i < plan.value_program.size(); i++) {
+    if (plan.value_program[i].index >= 0) {
+      plan.value_positions[plan.value_program[i].index] = i;
+    }
+  }
+
+  auto it = std::lower_bound(versions_.begin(), versions_.end(), schema_version,
+                             [](const VersionPlan& plan, int version) { return plan.schema_version < version; });
+  if (it != versions_.end() && it->schema_version == schema_version) {
+    *it = std::move(plan);
+  } else {
+    versions_.insert(it, std::move(plan));
+  }
+  return 0;
+}
+
+template <typename T>
+static void SetListCell(Row& row, int column, const std::any& data) {
+  const auto& list = std::any_cast<const std::optional<std::shared_ptr<std::vector<T>>>&>(data);
+  if (!list.has_value()) {
+    row.SetNull(column);
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    row.SetStringList(column, *list.value());
+  } else {
+    row.SetList(column, *list.value());
+  }
+}
+
+// The std::any of a column, as Decode produces it, into a cell.
+static void SetCell(Row& row, int column, BaseSchema::Type type, const std::any& data) {
+  switch (type) {
+    case BaseSchema::kBool:
+      row.SetScalar(column, std::any_cast<const std::optional<bool>&>(data));
+      break;
+    case BaseSchema::kInteger:
+      row.SetScalar(column, std::any_cast<const std::optional<int32_t>&>(data));
+      break;
+    case BaseSchema::kFloat:
+      row.SetScalar(column, std::any_cast<const std::optional<float>&>(data));
+      break;
+    case BaseSchema::kLong:
+      row.SetScalar(column, std::any_cast<const std::optional<int64_t>&>(data));
+      break;
+    case BaseSchema::kDouble:
+      row.SetScalar(column, std::any_cast<const std::optional<double>&>(data));
+      break;
+    case BaseSchema::kString: {
+      const auto& str = std::any_cast<const std::optional<std::shared_ptr<std::string>>&>(data);
+      if (str.has_value()) {
+        row.SetString(column, *str.value());
+      } else {
+        row.SetNull(column);
+      }
+      break;
+    }
+    case BaseSchema::kBoolList:
+      SetListCell<bool>(row, column, data);
+      break;
+    case BaseSchema::kIntegerList:
+      SetListCell<int32_t>(row, column, data);
+      break;
+    case BaseSchema::kFloatList:
+      SetListCell<float>(row, column, data);
+      break;
+    case BaseSchema::kLongList:
+      SetListCell<int64_t>(row, column, data);
+      break;
+    case BaseSchema::kDoubleList:
+      SetListCell<double>(row, column, data);
+      break;
+    case BaseSchema::kStringList:
+      SetListCell<std::string>(row, column, data);
+      break;
+  }
+}
+
+int RecordDecoder::SetColumnDefault(int index, const std::any& data) {
+  auto column = std::find_if(program_.begin(), program_.end(),
+                             [index](const ColumnDecoder& column) { return !column.key && column.index == index; });
+  if (column == program_.end()) {
+    //"Not A Value Column"
+    return -1;
+  }
+  defaults_[index] = data;
+  if (data.has_value()) {
+    SetCell(default_row_, index, column->schema->GetType(), data);
+  } else {
+    default_row_.SetNull(index);
+  }
+  return 0;
+}
+
+static void ResetRecord(std::vector<std::any>& record, size_t size) { record.resize(size); }
+
+static void ResetRecord(Row& row, size_t size) { row.Reset(size); }
+
+static void DecodeColumn(const ColumnDecoder& column, BufView& buf, std::vector<std::any>& record, int slot) {
+  column.decode(column.schema, buf, record.at(slot));
+}
+
+static void DecodeColumn(const ColumnDecoder& column, BufView& buf, Row& row, int slot) {
+  column.decode_row(column.schema, buf, row, slot);
+}
+
+static void CopyDefault(const std::any& data, const RowView& /*data_row*/, int /*index*/,
+                        std::vector<std::any>& record, int slot) {
+  record.at(slot) = data;
+}
+
+static void CopyDefault(const std::any& /*data*/, const RowView& data_row, int index, Row& row, int slot) {
+  row.SetCell(slot, data_row, index);
+}
+
+bool RecordDecoder::CheckPrefix(BufView& buf) const {
+  // |namespace|id| ... |tag|, a shorter key is truncated.
+  if (buf.Size() < 13) {
+    return false;
+  }
   // skip name space
   buf.Skip(1);
   return buf.ReadLong() == common_id_;
 }
 
-bool RecordDecoder::CheckReverseTag(Buf& buf) const {
+bool RecordDecoder::CheckReverseTag(BufView& buf) const {
   if (buf.ReverseRead() <= codec_version_) {
     buf.ReverseSkip(3);
     return true;
@@ -99,17 +410,60 @@ bool RecordDecoder::CheckReverseTag(Buf& buf) const {
   return false;
 }
 
-bool RecordDecoder::CheckSchemaVersion(Buf& buf) const { return buf.ReadInt() <= schema_version_; }
+bool RecordDecoder::ReadSchemaVersion(BufView& buf, const VersionPlan*& plan) const {
+  plan = nullptr;
+  if (buf.Size() < 4) {
+    return false;
+  }
+  int schema_version = buf.ReadInt();
+  if (schema_version > schema_version_) {
+    return false;
+  }
+  if (schema_version < schema_version_) {
+    for (const auto& version : versions_) {
+      if (version.schema_version == schema_version) {
+        plan = &version;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename Record>
+void RecordDecoder::FillDefault(const ColumnDecoder& column, Record& record, int slot) const {
+  if (defaults_[column.index].has_value()) {
+    CopyDefault(defaults_[column.index], default_row_, column.index, record, slot);
+  } else {
+    // A value read at the end is null.
+    BufView end(std::string_view(), this->le_);
+    DecodeColumn(column, end, record, slot);
+  }
+}
 
-void DecodeOrSkip(const std::shared_ptr<BaseSchema>& schema, Buf& key_buf, Buf& value_buf,
-                  std::vector<std::any>& record, int record_index, bool skip) {
-  cast_and_decode_or_skip_func_ptrs[static_cast<int>(schema->GetType())](schema, key_buf, value_buf, record,
-                                                                         record_index, skip);
+template <typename Record>
+void RecordDecoder::InternalDecodeVersion(const VersionPlan& plan, BufView& value_buf, const std::vector<int>* slots,
+                                          Record& record) const {
+  for (const auto& column : plan.value_program) {
+    int slot = column.ordinal < 0 ? -1 : slots == nullptr ? column.index : (*slots)[column.ordinal];
+    if (slot < 0) {
+      column.skip(column.schema, value_buf);
+    } else {
+      DecodeColumn(column, value_buf, record, slot);
+    }
+  }
+  for (int ordinal : plan.added) {
+    int slot = slots == nullptr ? program_[ordinal].index : (*slots)[ordinal];
+    if (slot >= 0) {
+      FillDefault(program_[ordinal], record, slot);
+    }
+  }
 }
 
-int RecordDecoder::Decode(const std::string& key, const std::string& value, std::vector<std::any>& record) {
-  Buf key_buf(key, this->le_);
-  Buf value_buf(value, this->le_);
+template <typename Record>
+int RecordDecoder::InternalDecode(std::string_view key, std::string_view value, Record& record) const {
+  BufView key_buf(key, this->le_);
+  BufView value_buf(value, this->le_);
   if (!CheckPrefix(key_buf)) {
     //"Wrong Common Id"
     return -1;
@@ -120,23 +474,36 @@ int RecordDecoder::Decode(const std::string& key, const std::string& value, std:
     return -1;
   }
 
-  if (!CheckSchemaVersion(value_buf)) {
+  const VersionPlan* plan;
+  if (!ReadSchemaVersion(value_buf, plan)) {
     //"Wrong Schema Version"
     return -1;
   }
 
-  record.resize(schemas_->size());
-  for (const auto& bs : *schemas_) {
-    if (bs) {
-      DecodeOrSkip(bs, key_buf, value_buf, record, bs->GetIndex(), false);
+  ResetRecord(record, schemas_->size());
+  if (plan != nullptr) {
+    for (const auto& column : program_) {
+      if (column.key) {
+        DecodeColumn(column, key_buf, record, column.index);
+      }
+    }
+    InternalDecodeVersion(*plan, value_buf, nullptr, record);
+  } else {
+    for (const auto& column : program_) {
+      DecodeColumn(column, column.key ? key_buf : value_buf, record, column.index);
     }
   }
 
+  if (key_buf.IsCorrupt() || value_buf.IsCorrupt()) {
+    //"Length Past The End"
+    return -1;
+  }
   return 0;
 }
 
-int RecordDecoder::DecodeKey(const std::string& key, std::vector<std::any>& record /*output*/) {
-  Buf key_buf(key, this->le_);
+template <typename Record>
+int RecordDecoder::InternalDecodeKey(std::string_view key, Record& record) const {
+  BufView key_buf(key, this->le_);
 
   if (!CheckPrefix(key_buf)) {
     //"Wrong Common Id"
@@ -148,19 +515,21 @@ int RecordDecoder::DecodeKey(const std::string& key, std::vector<std::any>& reco
     return -1;
   }
 
-  record.resize(schemas_->size());
-  int index = 0;
-  for (const auto& bs : *schemas_) {
-    if (bs && bs->IsKey()) {
-      DecodeOrSkip(bs, key_buf, key_buf, record, index, false);
+  ResetRecord(record, schemas_->size());
+  for (const auto& column : program_) {
+    if (column.key) {
+      DecodeColumn(column, key_buf, record, column.position);
     }
-    index++;
   }
 
+  if (key_buf.IsCorrupt()) {
+    //"Length Past The End"
+    return -1;
+  }
   return 0;
 }
 
-int RecordDecoder::Decode(const KeyValue& key_value, std::vector<std::any>& record) {
+int RecordDecoder::Decode(const KeyValue& key_value, std::vector<std::any>& record) const {
   return Decode(*key_value.GetKey(), *key_value.GetValue(), record);
 }
 
@@ -178,15 +547,9 @@ inline bool IsSkipOnly(const std::vector<std::pair<int32_t, int32_t>>& indexed_m
   }
 }
 
-int RecordDecoder::Decode(const std::string& key, const std::string& value, const std::vector<int>& column_indexes,
-                          std::vector<std::any>& record) {
-  Buf key_buf(key, this->le_);
-  Buf value_buf(value, this->le_);
-  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) || !CheckSchemaVersion(value_buf)) {
-    return -1;
-  }
-
-  record.resize(column_indexes.size());
+Projection RecordDecoder::CreateProjection(const std::vector<int>& column_indexes) const {
+  Projection projection;
+  projection.output_size_ = column_indexes.size();
   int32_t n = 0;
   int32_t m = 0;
 
@@ -201,27 +564,905 @@ int RecordDecoder::Decode(const std::string& key, const std::string& value, cons
   // sort indexed_mapping_index
   std::sort(col_index_mapping.begin(), col_index_mapping.end());
 
-  // sort end indexed_mapping_index and mapping_index
-  // DINGO_LOG(DEBUG) << "indexed_mapping_index: ";
-  // for (auto p : col_index_mapping) {
-  //   DINGO_LOG(DEBUG) << "(" << p.first << ", " << p.second << ") ";
-  // }
-
+  // Resolve every column up to the last needed one, the rest of the row is never touched. Value columns start
+  // with the fixed width ones (see SortSchema), their offsets are known without reading the row.
   int record_index = 0;
-  for (auto& bs : *schemas_) {
+  int value_offset = 4;
+  bool in_fixed_prefix = true;
+  for (size_t i = 0; i < program_.size(); i++) {
     if ((int32_t)column_indexes.size() == n) {
+      break;
+    }
+    const ColumnDecoder& column = program_[i];
+    int target = IsSkipOnly(col_index_mapping, n, m, record_index) ? -1 : record_index;
+    if (column.key) {
+      projection.steps_.push_back({static_cast<int>(i), target, -1});
+    } else if (in_fixed_prefix && column.fixed_value_length >= 0) {
+      if (target >= 0) {
+        projection.steps_.push_back({static_cast<int>(i), target, value_offset});
+      }
+      value_offset += column.fixed_value_length;
+    } else {
+      // First variable length value column, continue sequentially from the end of the fixed prefix.
+      projection.steps_.push_back({static_cast<int>(i), target, in_fixed_prefix ? value_offset : -1});
+      in_fixed_prefix = false;
+    }
+  }
+  projection.program_size_ = program_.size();
+  projection.slots_.assign(program_.size(), -1);
+  for (size_t i = 0; i < column_indexes.size(); i++) {
+    if (column_indexes[i] >= 0 && column_indexes[i] < static_cast<int>(program_.size())) {
+      projection.slots_[column_indexes[i]] = i;
+    }
+  }
+
+  // Covered by the key, value columns need not even be skipped.
+  projection.key_only_ = std::all_of(projection.steps_.begin(), projection.steps_.end(), [this](const auto& step) {
+    return step.target < 0 || program_[step.column].key;
+  });
+  if (projection.key_only_) {
+    projection.steps_.erase(std::remove_if(projection.steps_.begin(), projection.steps_.end(),
+                                           [this](const auto& step) { return !program_[step.column].key; }),
+                            projection.steps_.end());
+  }
+  return projection;
+}
+
+bool Projection::IsKeyOnly() const { return this->key_only_; }
+
+// Null tag of the schemas, see BaseSchema.
+static constexpr char kNullTag = 0;
+
+// Column values as the filter compares them.
+template <typename T>
+using FilterValue = std::conditional_t<std::is_floating_point_v<T>, double,
+                                       std::conditional_t<std::is_arithmetic_v<T>, int64_t, std::string_view>>;
+
+template <typename V>
+static bool Satisfies(Predicate::Op op, const V& data, const V& lower, const V& upper) {
+  switch (op) {
+    case Predicate::kEqual:
+      return data == lower;
+    case Predicate::kLess:
+      return data < lower;
+    case Predicate::kLessEqual:
+      return !(lower < data);
+    case Predicate::kGreater:
+      return lower < data;
+    case Predicate::kGreaterEqual:
+      return !(data < lower);
+    case Predicate::kBetween:
+      return !(data < lower) && !(upper < data);
+    default:
+      return false;
+  }
+}
+
+// Settles the null checks and every comparison involving null, false if the values still need comparing.
+static bool MatchNull(const FilterTerm& term, bool null, bool& result) {
+  if (term.op == Predicate::kIsNull || term.op == Predicate::kIsNotNull) {
+    result = null == (term.op == Predicate::kIsNull);
+    return true;
+  }
+  if (null || term.null_constant) {
+    result = false;
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+static FilterValue<T> Bound(const FilterTerm& term, bool upper) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return upper ? term.upper_real : term.lower_real;
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    return upper ? term.upper_integer : term.lower_integer;
+  } else {
+    return upper ? term.upper_bytes : term.lower_bytes;
+  }
+}
+
+// Memcomparable keys: the encoded column against the encoded constants, null tag included.
+static bool MatchKeyBytes(const FilterTerm& term, BufView& buf) {
+  if (!buf.CheckRemainder(1)) {
+    return false;
+  }
+  const char* data = buf.Data() + buf.GetForwardPos();
+  bool null = term.schema->AllowNull() && data[0] == kNullTag;
+  term.skip(term.schema, buf);
+  if (!buf.CheckRemainder(0)) {
+    // Skipped past the end.
+    return false;
+  }
+  bool result;
+  if (MatchNull(term, null, result)) {
+    return result;
+  }
+  std::string_view bytes(data, buf.Data() + buf.GetForwardPos() - data);
+  return Satisfies<std::string_view>(term.op, bytes, term.lower_bytes, term.upper_bytes);
+}
+
+// Keys whose byte order does not sort, read without building a std::any.
+template <typename T, bool LE>
+static bool MatchKeyColumn(const FilterTerm& term, BufView& buf) {
+  auto* schema = static_cast<DingoSchema<std::optional<T>>*>(term.schema);
+  std::optional<T> data;
+  if (!CheckColumnLength<T>(term.schema, buf)) {
+    return false;
+  } else if constexpr (kFixedKeyByteOrder<T>) {
+    data = schema->template DecodeKey<LE>(&buf);
+  } else {
+    data = schema->DecodeKey(&buf);
+  }
+  bool result;
+  if (MatchNull(term, !data.has_value(), result)) {
+    return result;
+  }
+  return Satisfies<FilterValue<T>>(term.op, data.value(), Bound<T>(term, false), Bound<T>(term, true));
+}
+
+template <typename T, bool LE>
+static bool MatchValueColumn(const FilterTerm& term, BufView& buf) {
+  auto* schema = static_cast<DingoSchema<std::optional<T>>*>(term.schema);
+  std::optional<FilterValue<T>> data;
+  if (buf.IsEnd() || !CheckColumnLength<T>(term.schema, buf)) {
+    // A value read at the end is null.
+  } else if constexpr (std::is_same_v<T, std::shared_ptr<std::string>>) {
+    data = schema->DecodeValueView(&buf);
+  } else if constexpr (kFixedValueByteOrder<T>) {
+    std::optional<T> column = schema->template DecodeValue<LE>(&buf);
+    if (column.has_value()) {
+      data = column.value();
+    }
+  } else {
+    std::optional<T> column = schema->DecodeValue(&buf);
+    if (column.has_value()) {
+      data = column.value();
+    }
+  }
+  bool result;
+  if (MatchNull(term, !data.has_value(), result)) {
+    return result;
+  }
+  return Satisfies<FilterValue<T>>(term.op, data.value(), Bound<T>(term, false), Bound<T>(term, true));
+}
+
+template <typename T, bool LE>
+static int SetConstant(const std::any& data, bool upper, FilterTerm& term) {
+  const auto* constant = std::any_cast<std::optional<T>>(&data);
+  if (constant == nullptr) {
+    return -1;
+  }
+  if (!constant->has_value()) {
+    term.null_constant = true;
+    return 0;
+  }
+  std::string& bytes = upper ? term.upper_bytes : term.lower_bytes;
+  if (term.match == MatchKeyBytes) {
+    auto* schema = static_cast<DingoSchema<std::optional<T>>*>(term.schema);
+    Buf buf(16, LE);
+    if constexpr (kFixedKeyByteOrder<T>) {
+      schema->template EncodeKeyPrefix<LE>(&buf, *constant);
+    } else {
+      schema->EncodeKeyPrefix(&buf, *constant);
+    }
+    return buf.GetBytes(bytes) < 0 ? -1 : 0;
+  }
+  if constexpr (std::is_floating_point_v<T>) {
+    (upper ? term.upper_real : term.lower_real) = constant->value();
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    (upper ? term.upper_integer : term.lower_integer) = constant->value();
+  } else if (constant->value() == nullptr) {
+    term.null_constant = true;
+  } else {
+    bytes = *constant->value();
+  }
+  return 0;
+}
+
+template <typename T, bool LE>
+static int BindTerm(const Predicate& predicate, const std::any& default_data, FilterTerm& term) {
+  if (term.key) {
+    term.skip = SkipKeyColumn<T>;
+    // Sign flipped big endian numbers and grouped strings sort bytewise, little endian numbers do not.
+    if constexpr (LE || !kFixedKeyByteOrder<T>) {
+      term.match = MatchKeyBytes;
+    } else {
+      term.match = MatchKeyColumn<T, LE>;
+    }
+  } else {
+    term.skip = SkipValueColumn<T>;
+    term.match = MatchValueColumn<T, LE>;
+  }
+  if (predicate.op != Predicate::kIsNull && predicate.op != Predicate::kIsNotNull) {
+    if (SetConstant<T, LE>(predicate.value, false, term) < 0) {
+      return -1;
+    }
+    if (predicate.op == Predicate::kBetween && SetConstant<T, LE>(predicate.upper, true, term) < 0) {
+      return -1;
+    }
+  }
+  if (!term.key && default_data.has_value()) {
+    Buf buf(16, LE);
+    auto* schema = static_cast<DingoSchema<std::optional<T>>*>(term.schema);
+    const auto& data = std::any_cast<const std::optional<T>&>(default_data);
+    if constexpr (kFixedValueByteOrder<T>) {
+      schema->template EncodeValue<LE>(&buf, data);
+    } else {
+      schema->EncodeValue(&buf, data);
+    }
+    buf.GetBytes(term.default_value);
+  }
+  return 0;
+}
+
+template <bool LE>
+int RecordDecoder::CompileTerm(const Predicate& predicate, FilterTerm& term) const {
+  const std::any& default_data = defaults_[predicate.index];
+  switch (term.schema->GetType()) {
+    case BaseSchema::kBool:
+      return BindTerm<bool, LE>(predicate, default_data, term);
+    case BaseSchema::kInteger:
+      return BindTerm<int32_t, LE>(predicate, default_data, term);
+    case BaseSchema::kFloat:
+      return BindTerm<float, LE>(predicate, default_data, term);
+    case BaseSchema::kLong:
+      return BindTerm<int64_t, LE>(predicate, default_data, term);
+    case BaseSchema::kDouble:
+      return BindTerm<double, LE>(predicate, default_data, term);
+    case BaseSchema::kString:
+      return BindTerm<std::shared_ptr<std::string>, LE>(predicate, default_data, term);
+    default:
+      // Lists have no order.
+      return -1;
+  }
+}
+
+int RecordDecoder::CreateFilter(const std::vector<Predicate>& predicates, Filter& filter) const {
+  filter.key_terms_.clear();
+  filter.value_terms_.clear();
+  // Offsets known without reading the row, up to the first variable length value column (see CreateProjection).
+  std::vector<int> value_offsets(value_program_.size(), -1);
+  int value_offset = 4;
+  for (size_t i = 0; i < value_program_.size(); i++) {
+    value_offsets[i] = value_offset;
+    if (value_program_[i].fixed_value_length < 0) {
+      break;
+    }
+    value_offset += value_program_[i].fixed_value_length;
+  }
+
+  for (const auto& predicate : predicates) {
+    if (predicate.index < 0 || predicate.index >= static_cast<int>(locations_.size()) ||
+        locations_[predicate.index].position < 0) {
+      return -1;
+    }
+    const ColumnLocation& location = locations_[predicate.index];
+    FilterTerm term{};
+    term.op = predicate.op;
+    term.key = location.key;
+    term.index = predicate.index;
+    term.position = location.position;
+    term.value_offset = location.key ? -1 : value_offsets[location.position];
+    term.schema = (location.key ? key_program_ : value_program_)[location.position].schema;
+    if ((this->le_ ? CompileTerm<true>(predicate, term) : CompileTerm<false>(predicate, term)) < 0) {
+      return -1;
+    }
+    (location.key ? filter.key_terms_ : filter.value_terms_).push_back(std::move(term));
+  }
+
+  auto by_position = [](const FilterTerm& a, const FilterTerm& b) { return a.position < b.position; };
+  std::stable_sort(filter.key_terms_.begin(), filter.key_terms_.end(), by_position);
+  std::stable_sort(filter.value_terms_.begin(), filter.value_terms_.end(), by_position);
+  return 0;
+}
+
+// Walks buf forward through the columns of program, every column is read at most once per term. positions maps the
+// record index to an older value layout, nullptr for the current one. 1 if every term matches, 0 if one does not, -1
+// if a length in the row runs past its end.
+static int MatchColumns(const std::vector<FilterTerm>& terms, const std::vector<ColumnDecoder>& program,
+                         const std::vector<int>* positions, BufView buf, bool le) {
+  BufView start = buf;
+  BufView last = buf;
+  int last_position = -1;
+  int next = 0;
+  for (const auto& term : terms) {
+    int position = positions == nullptr ? term.position : (*positions)[term.index];
+    if (position < 0) {
+      // Added after that version, compare its default.
+      BufView missing(term.default_value, le);
+      if (!term.match(term, missing)) {
+        return 0;
+      }
+      continue;
+    }
+    if (position != last_position) {
+      if (positions == nullptr && term.value_offset >= 0) {
+        // A value shorter than the offset ends before the column, which then reads as null.
+        buf.SetForwardPos(std::min(term.value_offset, buf.Size()));
+        next = position;
+      } else if (position < next) {
+        // Older layouts need not keep the current column order.
+        buf = start;
+        next = 0;
+      }
+      for (; next < position; next++) {
+        program[next].skip(program[next].schema, buf);
+      }
+      if (buf.IsCorrupt()) {
+        return -1;
+      }
+      last = buf;
+      last_position = position;
+    }
+    // Terms on the same column each read it from its start.
+    buf = last;
+    bool matched = term.match(term, buf);
+    if (buf.IsCorrupt()) {
+      return -1;
+    }
+    if (!matched) {
       return 0;
     }
-    if (bs) {
-      bool is_skip = IsSkipOnly(col_index_mapping, n, m, record_index);
-      DecodeOrSkip(bs, key_buf, value_buf, record, record_index, is_skip);
+    next = position + 1;
+  }
+  return 1;
+}
+
+int RecordDecoder::Match(std::string_view key, std::string_view value, const Filter& filter) const {
+  BufView key_buf(key, this->le_);
+  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf)) {
+    return -1;
+  }
+  // The key first, it is the cheaper one to walk.
+  int matched = MatchColumns(filter.key_terms_, key_program_, nullptr, key_buf, this->le_);
+  if (matched <= 0 || filter.value_terms_.empty()) {
+    return matched;
+  }
+
+  BufView value_buf(value, this->le_);
+  const VersionPlan* plan;
+  if (!ReadSchemaVersion(value_buf, plan)) {
+    return -1;
+  }
+  if (plan == nullptr) {
+    return MatchColumns(filter.value_terms_, value_program_, nullptr, value_buf, this->le_);
+  }
+  return MatchColumns(filter.value_terms_, plan->value_program, &plan->value_positions, value_buf, this->le_);
+}
+
+template <typename Record>
+int RecordDecoder::InternalDecode(std::string_view key, std::string_view value, const Projection& projection,
+                                  Record& record) const {
+  if (projection.program_size_ != program_.size()) {
+    //"Projection Of Other Schemas"
+    return -1;
+  }
+  if (projection.key_only_) {
+    return InternalDecodeKey(key, projection, record);
+  }
+
+  BufView key_buf(key, this->le_);
+  BufView value_buf(value, this->le_);
+  const VersionPlan* plan;
+  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) || !ReadSchemaVersion(value_buf, plan)) {
+    return -1;
+  }
+
+  ResetRecord(record, projection.output_size_);
+  if (plan != nullptr) {
+    for (const auto& step : projection.steps_) {
+      const ColumnDecoder& column = program_[step.column];
+      if (!column.key) {
+        continue;
+      }
+      if (step.target < 0) {
+        column.skip(column.schema, key_buf);
+      } else {
+        DecodeColumn(column, key_buf, record, step.target);
+      }
+    }
+    InternalDecodeVersion(*plan, value_buf, &projection.slots_, record);
+  } else {
+    for (const auto& step : projection.steps_) {
+      const ColumnDecoder& column = program_[step.column];
+      if (step.value_offset >= 0) {
+        // Values written by an older, narrower schema end early, seeking past the end reads as null.
+        value_buf.SetForwardPos(std::min(step.value_offset, value_buf.Size()));
+      }
+      BufView& buf = column.key ? key_buf : value_buf;
+      if (step.target < 0) {
+        column.skip(column.schema, buf);
+      } else {
+        DecodeColumn(column, buf, record, step.target);
+      }
+    }
+  }
+  if (key_buf.IsCorrupt() || value_buf.IsCorrupt()) {
+    //"Length Past The End"
+    return -1;
+  }
+  return 0;
+}
+
+template <typename Record>
+int RecordDecoder::InternalDecodeKey(std::string_view key, const Projection& projection, Record& record) const {
+  if (projection.program_size_ != program_.size() || !projection.key_only_) {
+    //"Projection Needs The Value"
+    return -1;
+  }
+
+  BufView key_buf(key, this->le_);
+  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf)) {
+    return -1;
+  }
+
+  ResetRecord(record, projection.output_size_);
+  for (const auto& step : projection.steps_) {
+    const ColumnDecoder& column = program_[step.column];
+    if (step.target < 0) {
+      column.skip(column.schema, key_buf);
+    } else {
+      DecodeColumn(column, key_buf, record, step.target);
+    }
+  }
+  if (key_buf.IsCorrupt()) {
+    //"Length Past The End"
+    return -1;
+  }
+  return 0;
+}
+
+int RecordDecoder::Decode(std::string_view key, std::string_view value, std::vector<std::any>& record) const {
+  return InternalDecode(key, value, record);
+}
+
+int RecordDecoder::DecodeKey(std::string_view key, std::vector<std::any>& record) const {
+  return InternalDecodeKey(key, record);
+}
+
+int RecordDecoder::Decode(std::string_view key, std::string_view value, const Projection& projection,
+                          std::vector<std::any>& record) const {
+  return InternalDecode(key, value, projection, record);
+}
+
+int RecordDecoder::DecodeKey(std::string_view key, const Projection& projection, std::vector<std::any>& record) const {
+  return InternalDecodeKey(key, projection, record);
+}
+
+int RecordDecoder::Decode(std::string_view key, std::string_view value, Row& row) const {
+  return InternalDecode(key, value, row);
+}
+
+int RecordDecoder::DecodeKey(std::string_view key, Row& row) const { return InternalDecodeKey(key, row); }
+
+int RecordDecoder::Decode(std::string_view key, std::string_view value, const Projection& projection, Row& row) const {
+  return InternalDecode(key, value, projection, row);
+}
+
+int RecordDecoder::DecodeKey(std::string_view key, const Projection& projection, Row& row) const {
+  return InternalDecodeKey(key, projection, row);
+}
+
+template <typename Source>
+int RecordDecoder::InternalDecodeBatch(int count, const Source& source, std::vector<Row>& rows) const {
+  rows.resize(count);
+  std::atomic<bool> failed{false};
+  ParallelFor(pool_.get(), count, min_parallel_rows_, [&](int begin, int end) {
+    for (int i = begin; i < end && !failed; i++) {
+      auto [key, value] = source(i);
+      if (InternalDecode(key, value, rows[i]) < 0) {
+        failed = true;
+      }
+    }
+  });
+  return failed ? -1 : count;
+}
+
+int RecordDecoder::DecodeBatch(const EncodedBatch& batch, std::vector<Row>& rows) const {
+  return InternalDecodeBatch(
+      batch.Size(), [&batch](int i) { return std::make_pair(batch.Key(i), batch.Value(i)); }, rows);
+}
+
+int RecordDecoder::DecodeBatch(const std::vector<KeyValue>& key_values, std::vector<Row>& rows) const {
+  return InternalDecodeBatch(
+      key_values.size(),
+      [&key_values](int i) {
+        return std::make_pair(std::string_view(*key_values[i].GetKey()), std::string_view(*key_values[i].GetValue()));
+      },
+      rows);
+}
+
+// Fixed width value columns at a known offset, one column over all the rows of the current layout. Numbers are
+// loaded straight from the bytes, bools and floats keep the byte order of their schema.
+template <typename T, bool LE>
+static void DecodeFixedValues(const std::vector<std::string_view>& values, const std::vector<uint8_t>& current,
+                              const ColumnDecoder& decoder, int offset, ColumnVector& column) {
+  bool nullable = decoder.schema->AllowNull();
+  size_t end = offset + decoder.fixed_value_length;
+  int count = values.size();
+  for (int row = 0; row < count; row++) {
+    if (!current[row] || values[row].size() < end) {
+      // Older layouts are decoded by row, short values are null.
+      continue;
+    }
+    const char* data = values[row].data() + offset;
+    if (nullable && data[0] == kNullTag) {
+      continue;
+    }
+    if constexpr (kFixedValueByteOrder<T>) {
+      data += nullable;
+      T value;
+      if constexpr (sizeof(T) == 4) {
+        uint32_t bits = LoadUint32<LE>(data);
+        memcpy(&value, &bits, 4);
+      } else {
+        uint64_t bits = LoadUint64<LE>(data);
+        memcpy(&value, &bits, 8);
+      }
+      memcpy(column.data.data() + static_cast<size_t>(row) * sizeof(T), &value, sizeof(T));
+      column.validity[row / 8] |= 1 << (row % 8);
+      column.null_count--;
+    } else {
+      BufView buf(std::string_view(data, decoder.fixed_value_length), LE);
+      column.Set<T>(row, static_cast<DingoSchema<std::optional<T>>*>(decoder.schema)->DecodeValue(&buf).value());
     }
   }
+}
+
+template <bool LE>
+static void DecodeFixedValues(const std::vector<std::string_view>& values, const std::vector<uint8_t>& current,
+                              const ColumnDecoder& decoder, int offset, ColumnVector& column) {
+  switch (column.type) {
+    case BaseSchema::kBool:
+      DecodeFixedValues<bool, LE>(values, current, decoder, offset, column);
+      break;
+    case BaseSchema::kInteger:
+      DecodeFixedValues<int32_t, LE>(values, current, decoder, offset, column);
+      break;
+    case BaseSchema::kFloat:
+      DecodeFixedValues<float, LE>(values, current, decoder, offset, column);
+      break;
+    case BaseSchema::kLong:
+      DecodeFixedValues<int64_t, LE>(values, current, decoder, offset, column);
+      break;
+    case BaseSchema::kDouble:
+      DecodeFixedValues<double, LE>(values, current, decoder, offset, column);
+      break;
+    default:
+      break;
+  }
+}
+
+template <typename T>
+static void AppendListCell(const RowView& view, int cell, ColumnVector& column) {
+  int size = view.GetListSize(cell);
+  for (int i = 0; i < size; i++) {
+    if constexpr (std::is_same_v<T, std::string>) {
+      column.child->AppendString(view.GetStringListElement(cell, i));
+    } else {
+      column.child->Append<T>(view.GetListElement<T>(cell, i));
+    }
+  }
+  column.AppendList();
+}
+
+// Fixed width columns are Set at row, strings and lists appended, so rows must come in order.
+static void CopyCell(const RowView& view, int cell, int row, ColumnVector& column) {
+  if (view.IsNull(cell)) {
+    if (!ColumnVector::IsFixedWidth(column.type)) {
+      column.AppendNull();
+    }
+    return;
+  }
+  switch (column.type) {
+    case BaseSchema::kBool:
+      column.Set<bool>(row, view.GetBool(cell));
+      break;
+    case BaseSchema::kInteger:
+      column.Set<int32_t>(row, view.GetInt(cell));
+      break;
+    case BaseSchema::kFloat:
+      column.Set<float>(row, view.GetFloat(cell));
+      break;
+    case BaseSchema::kLong:
+      column.Set<int64_t>(row, view.GetLong(cell));
+      break;
+    case BaseSchema::kDouble:
+      column.Set<double>(row, view.GetDouble(cell));
+      break;
+    case BaseSchema::kString:
+      column.AppendString(view.GetString(cell));
+      break;
+    case BaseSchema::kBoolList:
+      AppendListCell<bool>(view, cell, column);
+      break;
+    case BaseSchema::kIntegerList:
+      AppendListCell<int32_t>(view, cell, column);
+      break;
+    case BaseSchema::kFloatList:
+      AppendListCell<float>(view, cell, column);
+      break;
+    case BaseSchema::kLongList:
+      AppendListCell<int64_t>(view, cell, column);
+      break;
+    case BaseSchema::kDoubleList:
+      AppendListCell<double>(view, cell, column);
+      break;
+    case BaseSchema::kStringList:
+      AppendListCell<std::string>(view, cell, column);
+      break;
+  }
+}
+
+template <typename Source>
+int RecordDecoder::InternalDecodeBatch(int count, const Source& source, const Projection& projection,
+                                       ColumnBatch& batch) const {
+  if (projection.program_size_ != program_.size()) {
+    //"Projection Of Other Schemas"
+    return -1;
+  }
+  // Program ordinal of every output column, each column at most once.
+  std::vector<int> ordinals(projection.output_size_, -1);
+  for (size_t ordinal = 0; ordinal < projection.slots_.size(); ordinal++) {
+    if (projection.slots_[ordinal] >= 0) {
+      ordinals[projection.slots_[ordinal]] = ordinal;
+    }
+  }
+  batch.columns.resize(ordinals.size());
+  batch.num_rows = count;
+  for (size_t i = 0; i < ordinals.size(); i++) {
+    if (ordinals[i] < 0) {
+      return -1;
+    }
+    ColumnVector& column = batch.columns[i];
+    column.Reset(program_[ordinals[i]].schema->GetType());
+    if (ColumnVector::IsFixedWidth(column.type)) {
+      column.Resize(count);
+    }
+  }
+
+  std::vector<std::string_view> keys(count);
+  std::vector<std::string_view> values(count);
+  // Records in the current layout, the others are decoded by row.
+  std::vector<uint8_t> current(count, 1);
+  for (int i = 0; i < count; i++) {
+    std::tie(keys[i], values[i]) = source(i);
+    BufView key_buf(keys[i], this->le_);
+    if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf)) {
+      return -1;
+    }
+    if (!projection.key_only_) {
+      BufView value_buf(values[i], this->le_);
+      const VersionPlan* plan;
+      if (!ReadSchemaVersion(value_buf, plan)) {
+        return -1;
+      }
+      current[i] = plan == nullptr;
+    }
+  }
+
+  // Fixed width values at a known offset are decoded a column at a time, the rest a row at a time.
+  std::vector<const Projection::Step*> fixed;
+  std::vector<int> rest;
+  std::vector<int> rest_outputs;
+  for (const auto& step : projection.steps_) {
+    const ColumnDecoder& column = program_[step.column];
+    if (step.target < 0) {
+      continue;
+    }
+    if (!column.key && step.value_offset >= 0 && column.fixed_value_length >= 0) {
+      fixed.push_back(&step);
+    } else {
+      rest.push_back(ordinals[step.target]);
+      rest_outputs.push_back(step.target);
+    }
+  }
+  ParallelFor(count >= min_parallel_rows_ ? pool_.get() : nullptr, fixed.size(), 1, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const Projection::Step& step = *fixed[i];
+      if (this->le_) {
+        DecodeFixedValues<true>(values, current, program_[step.column], step.value_offset, batch.columns[step.target]);
+      } else {
+        DecodeFixedValues<false>(values, current, program_[step.column], step.value_offset,
+                                 batch.columns[step.target]);
+      }
+    }
+  });
+
+  Projection rest_projection = CreateProjection(rest);
+  Row row;
+  for (int i = 0; i < count; i++) {
+    if (current[i]) {
+      if (rest.empty()) {
+        continue;
+      }
+      if (InternalDecode(keys[i], values[i], rest_projection, row) < 0) {
+        return -1;
+      }
+      for (size_t cell = 0; cell < rest_outputs.size(); cell++) {
+        CopyCell(row, cell, i, batch.columns[rest_outputs[cell]]);
+      }
+    } else {
+      if (InternalDecode(keys[i], values[i], projection, row) < 0) {
+        return -1;
+      }
+      for (size_t cell = 0; cell < ordinals.size(); cell++) {
+        CopyCell(row, cell, i, batch.columns[cell]);
+      }
+    }
+  }
+  return count;
+}
+
+int RecordDecoder::DecodeBatch(const EncodedBatch& batch, const Projection& projection, ColumnBatch& columns) const {
+  return InternalDecodeBatch(
+      batch.Size(), [&batch](int i) { return std::make_pair(batch.Key(i), batch.Value(i)); }, projection, columns);
+}
+
+int RecordDecoder::DecodeBatch(const std::vector<KeyValue>& key_values, const Projection& projection,
+                               ColumnBatch& columns) const {
+  return InternalDecodeBatch(
+      key_values.size(),
+      [&key_values](int i) {
+        return std::make_pair(std::string_view(*key_values[i].GetKey()), std::string_view(*key_values[i].GetValue()));
+      },
+      projection, columns);
+}
+
+int RecordDecoder::DecodeArrow(const EncodedBatch& batch, const Projection& projection, ArrowSchema* schema,
+                               ArrowArray* array) const {
+  ColumnBatch columns;
+  if (DecodeBatch(batch, projection, columns) < 0) {
+    return -1;
+  }
+  // Fields are named after the schemas, by record index if unnamed.
+  std::vector<std::string> names(projection.output_size_);
+  for (size_t ordinal = 0; ordinal < projection.slots_.size(); ordinal++) {
+    if (projection.slots_[ordinal] >= 0) {
+      const ColumnDecoder& column = program_[ordinal];
+      const std::string& name = column.schema->GetName();
+      names[projection.slots_[ordinal]] = name.empty() ? std::to_string(column.index) : name;
+    }
+  }
+  return ExportArrow(std::move(columns), names, schema, array);
+}
+
+int RecordDecoder::Decode(std::string_view key, std::string_view value, LazyRecord& record) const {
+  BufView key_buf(key, this->le_);
+  BufView value_buf(value, this->le_);
+  const VersionPlan* plan;
+  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) || !ReadSchemaVersion(value_buf, plan)) {
+    return -1;
+  }
+
+  record.decoder_ = this;
+  record.value_program_ = plan != nullptr ? &plan->value_program : &value_program_;
+  record.value_positions_ = plan != nullptr ? &plan->value_positions : nullptr;
+  record.key_buf_ = key_buf;
+  record.value_buf_ = value_buf;
+  record.key_starts_.assign(1, {key_buf.GetForwardPos(), key_buf.GetReversePos()});
+  record.value_starts_.assign(1, {value_buf.GetForwardPos(), value_buf.GetReversePos()});
+  record.columns_.resize(schemas_->size());
+  record.decoded_.assign(schemas_->size(), false);
+  record.arena_.Reset();
   return 0;
 }
 
+template <typename Visit>
+void RecordDecoder::LazyVisit(LazyRecord& record, bool key, int position, const Visit& visit) const {
+  BufView& buf = key ? record.key_buf_ : record.value_buf_;
+  std::vector<LazyRecord::Cursor>& starts = key ? record.key_starts_ : record.value_starts_;
+  const std::vector<ColumnDecoder>& program = key ? key_program_ : *record.value_program_;
+  int next = starts.size() - 1;
+  if (position < next) {
+    // Walked past already, start from where it was seen.
+    BufView view = buf;
+    view.SetForwardPos(starts[position].forward);
+    view.SetReversePos(starts[position].reverse);
+    visit(program[position], view);
+    if (view.IsCorrupt()) {
+      buf.SetCorrupt();
+    }
+    return;
+  }
+  for (; next < position; next++) {
+    program[next].skip(program[next].schema, buf);
+    starts.push_back({buf.GetForwardPos(), buf.GetReversePos()});
+  }
+  visit(program[position], buf);
+  starts.push_back({buf.GetForwardPos(), buf.GetReversePos()});
+}
+
+const std::any& RecordDecoder::LazyDecode(LazyRecord& record, int index) const {
+  std::any& output = record.columns_.at(index);
+  record.decoded_[index] = true;
+  const ColumnLocation& location = locations_[index];
+  if (location.position < 0) {
+    output.reset();
+    return output;
+  }
+  int position = location.position;
+  if (!location.key && record.value_positions_ != nullptr) {
+    position = (*record.value_positions_)[index];
+    if (position < 0) {
+      FillDefault(value_program_[location.position], record.columns_, index);
+      return output;
+    }
+  }
+
+  LazyVisit(record, location.key, position, [&record, index](const ColumnDecoder& column, BufView& buf) {
+    DecodeColumn(column, buf, record.columns_, index);
+  });
+  return output;
+}
+
+static std::optional<std::string_view> StringView(const std::any& data) {
+  if (!data.has_value()) {
+    return std::nullopt;
+  }
+  const auto& value = std::any_cast<const std::optional<std::shared_ptr<std::string>>&>(data);
+  if (!value.has_value() || value.value() == nullptr) {
+    return std::nullopt;
+  }
+  return std::string_view(*value.value());
+}
+
+int RecordDecoder::LazyDecodeString(LazyRecord& record, int index, std::optional<std::string_view>& view) const {
+  const ColumnLocation& location = locations_.at(index);
+  if (location.position < 0 ||
+      (location.key ? key_program_ : value_program_)[location.position].schema->GetType() != BaseSchema::kString) {
+    return -1;
+  }
+  if (record.decoded_[index]) {
+    view = StringView(record.columns_[index]);
+    return 0;
+  }
+  int position = location.position;
+  if (!location.key && record.value_positions_ != nullptr) {
+    position = (*record.value_positions_)[index];
+    if (position < 0) {
+      view = StringView(defaults_[index]);
+      return 0;
+    }
+  }
+
+  using StringSchema = DingoSchema<std::optional<std::shared_ptr<std::string>>>;
+  LazyVisit(record, location.key, position, [&record, &view, &location](const ColumnDecoder& column, BufView& buf) {
+    auto* schema = static_cast<StringSchema*>(column.schema);
+    if (location.key) {
+      view = schema->DecodeKeyView(&buf, &record.arena_);
+    } else {
+      view = buf.IsEnd() ? std::nullopt : schema->DecodeValueView(&buf);
+    }
+  });
+  return (location.key ? record.key_buf_ : record.value_buf_).IsCorrupt() ? -1 : 0;
+}
+
+int LazyRecord::Size() const { return columns_.size(); }
+
+const std::any& LazyRecord::Get(int index) {
+  if (decoded_.at(index)) {
+    return columns_[index];
+  }
+  return decoder_->LazyDecode(*this, index);
+}
+
+bool LazyRecord::IsDecoded(int index) const { return decoded_.at(index); }
+
+bool LazyRecord::IsCorrupt() const { return key_buf_.IsCorrupt() || value_buf_.IsCorrupt(); }
+
+int LazyRecord::GetString(int index, std::optional<std::string_view>& view) {
+  return decoder_->LazyDecodeString(*this, index, view);
+}
+
+int RecordDecoder::Decode(std::string_view key, std::string_view value, const std::vector<int>& column_indexes,
+                          std::vector<std::any>& record) const {
+  return Decode(key, value, CreateProjection(column_indexes), record);
+}
+
 int RecordDecoder::Decode(const KeyValue& key_value, const std::vector<int>& column_indexes,
-                          std::vector<std::any>& record) {
+                          std::vector<std::any>& record) const {
   return Decode(*key_value.GetKey(), *key_value.GetValue(), column_indexes, record);
 }
 
@@ -15,12 +15,20 @@
 #ifndef DINGO_SERIAL_RECORD_DECODER_H_
 #define DINGO_SERIAL_RECORD_DECODER_H_
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "any"
 #include "functional"
 #include "keyvalue.h"
 #include "optional"
+#include "serial/arrow_c_data.h"
+#include "serial/column_batch.h"
+#include "serial/encoded_batch.h"
+#include "serial/row.h"
 #include "serial/schema/boolean_list_schema.h"
 #include "serial/schema/boolean_schema.h"
 #include "serial/schema/double_list_schema.h"
@@ -33,37 +41,307 @@
 #include "serial/schema/long_schema.h"
 #include "serial/schema/string_list_schema.h"
 #include "serial/schema/string_schema.h"
+#include "serial/string_arena.h"
+#include "serial/thread_pool.h"
 #include "serial/utils.h"
 
 namespace dingodb {
 
+// One step of the decode program, compiled from the schemas in Init. The functions are bound to the concrete schema
+// type, to the key or value side and to the codec byte order, so Decode neither casts nor touches the schema
+// shared_ptrs.
+struct ColumnDecoder {
+  BaseSchema* schema;
+  // Place in the schema vector, among the non-null schemas, and in the record.
+  int position;
+  int ordinal;
+  int index;
+  bool key;
+  // Encoded length of a fixed width value column, -1 for keys and variable length values.
+  int fixed_value_length;
+  // decode reads from the key or the value view depending on key, a value read past the end yields null.
+  void (*decode)(BaseSchema* schema, BufView& buf, std::any& column);
+  void (*skip)(BaseSchema* schema, BufView& buf);
+  // Same as decode, into a cell of a typed row.
+  void (*decode_row)(BaseSchema* schema, BufView& buf, Row& row, int column);
+};
+
+// Value layout of an older schema version, compiled by RecordDecoder::AddSchemaVersion.
+struct VersionPlan {
+  int schema_version;
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas;
+  // Value columns in the order that version wrote them. index and ordinal are those of the matching current column,
+  // -1 for a column dropped since.
+  std::vector<ColumnDecoder> value_program;
+  // Ordinals of the current value columns the version lacks.
+  std::vector<int> added;
+  // Place in value_program by record index, -1 for a column the version lacks.
+  std::vector<int> value_positions;
+};
+
+// Column-selective decode plan for one column_indexes list. Build it once with RecordDecoder::CreateProjection and
+// reuse it for every row of a scan; it stays valid as long as the decoder is not re-initialized.
+class Projection {
+ public:
+  // True when every projected column lives in the key, the value is then never read.
+  bool IsKeyOnly() const;
+
+ private:
+  friend class RecordDecoder;
+
+  struct Step {
+    // Index into the decode program.
+    int column;
+    // Output slot, or -1 to skip the column.
+    int target;
+    // Absolute value offset to seek to before the column, -1 to continue from the current position.
+    int value_offset;
+  };
+
+  // Up to the last needed column. Skipped columns of the fixed width value prefix have no step at all, the needed
+  // ones are reached by offset.
+  std::vector<Step> steps_;
+  // Output slot of every column of the decode program, -1 if not projected. Values of older schema versions are
+  // matched to the output through it.
+  std::vector<int> slots_;
+  size_t output_size_ = 0;
+  size_t program_size_ = 0;
+  bool key_only_ = false;
+};
+
+// Condition on one column for RecordDecoder::CreateFilter. value and upper are a std::optional of the column type as
+// Decode gives it, upper is only read by kBetween, whose bounds are inclusive. As in SQL, comparisons with null are
+// never true.
+struct Predicate {
+  enum Op { kEqual, kLess, kLessEqual, kGreater, kGreaterEqual, kBetween, kIsNull, kIsNotNull };
+
+  int index;
+  Op op;
+  std::any value;
+  std::any upper;
+};
+
+// One predicate of a Filter, compiled by RecordDecoder::CreateFilter.
+struct FilterTerm {
+  Predicate::Op op;
+  bool key;
+  int index;
+  // In the key or the value program.
+  int position;
+  // Absolute value offset of a column of the fixed width value prefix, -1 otherwise.
+  int value_offset;
+  BaseSchema* schema;
+  void (*skip)(BaseSchema* schema, BufView& buf);
+  // True with buf at the column, leaves buf after it.
+  bool (*match)(const FilterTerm& term, BufView& buf);
+  // A comparison with a null constant.
+  bool null_constant;
+  int64_t lower_integer;
+  int64_t upper_integer;
+  double lower_real;
+  double upper_real;
+  // The key encoding for bytewise terms, the string itself for value strings.
+  std::string lower_bytes;
+  std::string upper_bytes;
+  // Value encoding of the column default, for the older schema versions that lack the column.
+  std::string default_value;
+};
+
+// Conjunction of predicates evaluated on the encoded bytes, so that rejected rows are never decoded. Key columns are
+// compared bytewise against the constants in their key encoding, which orders like the values (except that -0.0
+// keys sort apart from 0.0). Value columns are read in place, fixed width ones by offset. Build it once with
+// RecordDecoder::CreateFilter; it stays valid as long as the decoder is not re-initialized.
+class Filter {
+ private:
+  friend class RecordDecoder;
+
+  // Sorted by position.
+  std::vector<FilterTerm> key_terms_;
+  std::vector<FilterTerm> value_terms_;
+};
+
+class RecordDecoder;
+
+// Record whose columns are decoded on first access. RecordDecoder::Decode validates the header and leaves cursors
+// into the key and value, every access resumes from the furthest column reached so far and remembers where the
+// columns it walks past start, so no column is scanned twice. The key and value bytes and the decoder must outlive
+// the record; reuse one LazyRecord across a scan to keep its buffers.
+class LazyRecord {
+ public:
+  int Size() const;
+  // Column index as Decode would output it, decoded on first access. The reference stays valid until the record is
+  // decoded again. A column whose length runs past the end of the row reads as null, see IsCorrupt.
+  const std::any& Get(int index);
+  bool IsDecoded(int index) const;
+  // A column read so far, or walked past, claimed more bytes than the row holds.
+  bool IsCorrupt() const;
+  // String column without a copy, nullopt for null. Views point into the value, into the key for a key string of
+  // up to 8 bytes, and otherwise into the record's arena. They stay valid until the record is decoded again. Returns
+  // -1 if index is not a string column, or its length runs past the end of the row.
+  int GetString(int index, std::optional<std::string_view>& view /*output*/);
+
+ private:
+  friend class RecordDecoder;
+
+  struct Cursor {
+    int forward;
+    int reverse;
+  };
+
+  const RecordDecoder* decoder_ = nullptr;
+  // Layout of the value, the current one or that of its older schema version.
+  const std::vector<ColumnDecoder>* value_program_ = nullptr;
+  const std::vector<int>* value_positions_ = nullptr;
+  BufView key_buf_{nullptr, 0, true};
+  BufView value_buf_{nullptr, 0, true};
+  // Start of every column reached so far, the views sit at the start of the last one.
+  std::vector<Cursor> key_starts_;
+  std::vector<Cursor> value_starts_;
+  std::vector<std::any> columns_;
+  std::vector<bool> decoded_;
+  // Key strings longer than one group.
+  StringArena arena_;
+};
+
+// The byte order and the column plan are fixed by Init, the schemas are only read and never modified, so codecs of
+// either byte order can share one schema vector. Once configured, a RecordDecoder is safe to share across threads: the
+// const decode calls may run concurrently, Init and the Set/Enable calls must not overlap with them.
 class RecordDecoder {
  private:
-  bool CheckPrefix(Buf& buf) const;
-  bool CheckReverseTag(Buf& buf) const;
-  bool CheckSchemaVersion(Buf& buf) const;
+  friend class LazyRecord;
+
+  // False for a key too short for its prefix and tag, CheckReverseTag relies on it.
+  bool CheckPrefix(BufView& buf) const;
+  bool CheckReverseTag(BufView& buf) const;
+  // False for a value too short for its version or newer than the decoder. plan is the registered layout of an older
+  // version, nullptr to decode with the current one.
+  bool ReadSchemaVersion(BufView& buf, const VersionPlan*& plan) const;
+  void CompileProgram();
+
+  // Shared by the std::any records and the typed rows.
+  template <typename Record>
+  int InternalDecode(std::string_view key, std::string_view value, Record& record) const;
+  template <typename Record>
+  int InternalDecodeKey(std::string_view key, Record& record) const;
+  template <typename Record>
+  int InternalDecode(std::string_view key, std::string_view value, const Projection& projection, Record& record) const;
+  template <typename Record>
+  int InternalDecodeKey(std::string_view key, const Projection& projection, Record& record) const;
+  // Runs visit(column, buf) with buf at the start of the column at position in the key or the value, walking forward
+  // and remembering column starts as needed.
+  template <typename Visit>
+  void LazyVisit(LazyRecord& record, bool key, int position, const Visit& visit) const;
+  const std::any& LazyDecode(LazyRecord& record, int index) const;
+  int LazyDecodeString(LazyRecord& record, int index, std::optional<std::string_view>& view) const;
+  // slots maps the current program to the output, nullptr for the whole record.
+  template <typename Record>
+  void InternalDecodeVersion(const VersionPlan& plan, BufView& value_buf, const std::vector<int>* slots,
+                             Record& record) const;
+  template <typename Record>
+  void FillDefault(const ColumnDecoder& column, Record& record, int slot) const;
+  // source(i) gives the key and value of the i-th record.
+  template <typename Source>
+  int InternalDecodeBatch(int count, const Source& source, std::vector<Row>& rows) const;
+  template <typename Source>
+  int InternalDecodeBatch(int count, const Source& source, const Projection& projection, ColumnBatch& batch) const;
+  template <bool LE>
+  int CompileTerm(const Predicate& predicate, FilterTerm& term) const;
 
   int codec_version_ = 1;
   int schema_version_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas_;
   long common_id_;
   bool le_;
+  std::vector<ColumnDecoder> program_;
+  // The program split into the key and the value stream, and where each record index sits in them (position -1 for
+  // an index without a column).
+  struct ColumnLocation {
+    bool key;
+    int position;
+  };
+  std::vector<ColumnDecoder> key_program_;
+  std::vector<ColumnDecoder> value_program_;
+  std::vector<ColumnLocation> locations_;
+  // Sorted by schema version.
+  std::vector<VersionPlan> versions_;
+  // By record index, for the columns older versions lack. Row outputs copy them from default_row_.
+  std::vector<std::any> defaults_;
+  Row default_row_;
+  std::shared_ptr<ThreadPool> pool_;
+  int min_parallel_rows_ = kDefaultMinParallelRows;
 
  public:
+  static constexpr int kDefaultMinParallelRows = 1024;
+
   RecordDecoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
   RecordDecoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id,
                 bool le);
 
   void Init(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
 
-  int Decode(const KeyValue& key_value, std::vector<std::any>& record /*output*/);
-  int Decode(const std::string& key, const std::string& value, std::vector<std::any>& record /*output*/);
-  int DecodeKey(const std::string& key, std::vector<std::any>& record /*output*/);
+  // Spread DecodeBatch over pool once a batch has at least min_parallel_rows records, smaller batches and a null
+  // pool decode on the calling thread.
+  void SetThreadPool(std::shared_ptr<ThreadPool> pool, int min_parallel_rows = kDefaultMinParallelRows);
+
+  // Register the value layout of an older schema version, values written with it are then decoded by its own plan.
+  // The index of a value column of schemas is its index in the current record, -1 for a column dropped since, so
+  // reordered columns land in place. Current columns the version lacks get their default. Key columns cannot change
+  // and are taken from the current schemas. Values of unregistered older versions decode with the current layout, as
+  // before. Returns -1 for a version not older than the decoder or a column that does not match the current ones.
+  int AddSchemaVersion(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas);
+  // Default of a value column for the versions that lack it, a std::optional of the column type as Decode gives it.
+  // Without one such columns decode as null. Returns -1 if index is not a current value column.
+  int SetColumnDefault(int index, const std::any& data);
+
+  int Decode(const KeyValue& key_value, std::vector<std::any>& record /*output*/) const;
+  // key and value are read in place, the referenced bytes are not copied. Returns -1 for a truncated row or one
+  // whose string or list lengths run past its end, every Decode overload checks the same way.
+  int Decode(std::string_view key, std::string_view value, std::vector<std::any>& record /*output*/) const;
+  int DecodeKey(std::string_view key, std::vector<std::any>& record /*output*/) const;
 
   int Decode(const KeyValue& key_value, const std::vector<int>& column_indexes,
-             std::vector<std::any>& record /*output*/);
-  int Decode(const std::string& key, const std::string& value, const std::vector<int>& column_indexes,
-             std::vector<std::any>& record /*output*/);
+             std::vector<std::any>& record /*output*/) const;
+  int Decode(std::string_view key, std::string_view value, const std::vector<int>& column_indexes,
+             std::vector<std::any>& record /*output*/) const;
+
+  // record[i] receives column column_indexes[i], without re-sorting the projection for every row.
+  Projection CreateProjection(const std::vector<int>& column_indexes) const;
+  int Decode(std::string_view key, std::string_view value, const Projection& projection,
+             std::vector<std::any>& record /*output*/) const;
+  // Index-only scans, the projection must be key-only.
+  int DecodeKey(std::string_view key, const Projection& projection, std::vector<std::any>& record /*output*/) const;
+
+  // Typed rows, strings and lists are decoded into the arena of row. Reusing one Row across a scan keeps its
+  // capacity, so steady state decodes do not allocate.
+  int Decode(std::string_view key, std::string_view value, Row& row /*output*/) const;
+  int DecodeKey(std::string_view key, Row& row /*output*/) const;
+  int Decode(std::string_view key, std::string_view value, const Projection& projection, Row& row /*output*/) const;
+  int DecodeKey(std::string_view key, const Projection& projection, Row& row /*output*/) const;
+
+  // Compile predicates over the columns of the current schema. Returns -1 for an index without a column, a list
+  // column, or a constant that is not a std::optional of the column type.
+  int CreateFilter(const std::vector<Predicate>& predicates, Filter& filter /*output*/) const;
+  // 1 if the record satisfies every predicate of filter, 0 if not, -1 if it is not a record of this decoder or a
+  // column filter reads runs past the end. Only the columns filter reads are touched.
+  int Match(std::string_view key, std::string_view value, const Filter& filter) const;
+
+  // Only checks the header, the columns are decoded as record reads them.
+  int Decode(std::string_view key, std::string_view value, LazyRecord& record /*output*/) const;
+
+  // rows[i] receives the i-th record, rows is resized to the batch and its Rows are reused. Returns the number of
+  // records, or -1 if any of them fails to decode.
+  int DecodeBatch(const EncodedBatch& batch, std::vector<Row>& rows /*output*/) const;
+  int DecodeBatch(const std::vector<KeyValue>& key_values, std::vector<Row>& rows /*output*/) const;
+  // Columnar: columns.columns[i] receives projected column i of every record. Fixed width values of the current
+  // layout are decoded a column at a time, other columns and older layouts a record at a time. Returns the number of
+  // records, or -1 if any of them fails to decode or the projection names a column twice or not at all.
+  int DecodeBatch(const EncodedBatch& batch, const Projection& projection, ColumnBatch& columns /*output*/) const;
+  int DecodeBatch(const std::vector<KeyValue>& key_values, const Projection& projection,
+                  ColumnBatch& columns /*output*/) const;
+  // Same, handed over as an Arrow struct array through the C Data Interface without copying the buffers, see
+  // ExportArrow. Fields are named after the schemas.
+  int DecodeArrow(const EncodedBatch& batch, const Projection& projection, ArrowSchema* schema /*output*/,
+                  ArrowArray* array /*output*/) const;
 };
 
 }  // namespace dingodb
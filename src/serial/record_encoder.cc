@@ -16,12 +16,17 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 // #include "common/helper.h"
 #include "serial/keyvalue.h"  // IWYU pragma: keep
+#include "serial/output_sink.h"
 
 namespace dingodb {
 
@@ -42,13 +47,302 @@ RecordEncoder::RecordEncoder(int schema_version, std::shared_ptr<std::vector<std
 void RecordEncoder::Init(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
                          long common_id) {
   this->schema_version_ = schema_version;
-  FormatSchema(schemas, this->le_);
   this->schemas_ = schemas;
   this->common_id_ = common_id;
   int32_t* size = GetApproPerRecordSize(schemas);
   this->key_buf_size_ = size[0];
-  this->value_buf_size_ = size[1];
   delete[] size;
+  CompilePlan();
+}
+
+template <typename T, bool LE>
+void EncodeKeyColumn(BaseSchema* schema, Buf& buf, const std::any& column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (kFixedKeyByteOrder<T>) {
+    dingo_schema->template EncodeKey<LE>(&buf, std::any_cast<const std::optional<T>&>(column));
+  } else {
+    dingo_schema->EncodeKey(&buf, std::any_cast<const std::optional<T>&>(column));
+  }
+}
+
+template <typename T, bool LE>
+void EncodeKeyPrefixColumn(BaseSchema* schema, Buf& buf, const std::any& column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (kFixedKeyByteOrder<T>) {
+    dingo_schema->template EncodeKeyPrefix<LE>(&buf, std::any_cast<const std::optional<T>&>(column));
+  } else {
+    dingo_schema->EncodeKeyPrefix(&buf, std::any_cast<const std::optional<T>&>(column));
+  }
+}
+
+template <typename T, bool LE>
+void EncodeKeyPrefixColumnFromString(BaseSchema* schema, Buf& buf, const std::string& column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (std::is_same_v<T, std::shared_ptr<std::string>>) {
+    dingo_schema->EncodeKeyPrefix(&buf, std::optional<T>(std::make_shared<std::string>(column)));
+  } else if constexpr (kFixedKeyByteOrder<T>) {
+    dingo_schema->template EncodeKeyPrefix<LE>(&buf, std::optional<T>(RecordEncoder::StringToBool(column)));
+  } else {
+    dingo_schema->EncodeKeyPrefix(&buf, std::optional<T>(RecordEncoder::StringToBool(column)));
+  }
+}
+
+template <typename T, bool LE>
+void EncodeValueColumn(BaseSchema* schema, Buf& buf, const std::any& column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (kFixedValueByteOrder<T>) {
+    dingo_schema->template EncodeValue<LE>(&buf, std::any_cast<const std::optional<T>&>(column));
+  } else {
+    dingo_schema->EncodeValue(&buf, std::any_cast<const std::optional<T>&>(column));
+  }
+}
+
+template <typename T>
+int EncodedKeyLength(BaseSchema* schema, const std::any& column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  return dingo_schema->GetEncodedKeyLength(std::any_cast<const std::optional<T>&>(column));
+}
+
+template <typename T>
+int EncodedValueLength(BaseSchema* schema, const std::any& column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  return dingo_schema->GetEncodedValueLength(std::any_cast<const std::optional<T>&>(column));
+}
+
+// Scalar cells go through the optional overloads of the schemas, strings and lists through their row overloads.
+template <typename T, bool LE>
+void EncodeKeyCell(BaseSchema* schema, Buf& buf, const RowView& row, int column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (!std::is_arithmetic_v<T>) {
+    dingo_schema->EncodeKey(&buf, row, column);
+  } else if constexpr (kFixedKeyByteOrder<T>) {
+    dingo_schema->template EncodeKey<LE>(&buf, row.GetScalar<T>(column));
+  } else {
+    dingo_schema->EncodeKey(&buf, row.GetScalar<T>(column));
+  }
+}
+
+template <typename T, bool LE>
+void EncodeValueCell(BaseSchema* schema, Buf& buf, const RowView& row, int column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (!std::is_arithmetic_v<T>) {
+    if constexpr (kFixedValueByteOrder<T>) {
+      dingo_schema->template EncodeValue<LE>(&buf, row, column);
+    } else {
+      dingo_schema->EncodeValue(&buf, row, column);
+    }
+  } else if constexpr (kFixedValueByteOrder<T>) {
+    dingo_schema->template EncodeValue<LE>(&buf, row.GetScalar<T>(column));
+  } else {
+    dingo_schema->EncodeValue(&buf, row.GetScalar<T>(column));
+  }
+}
+
+template <typename T>
+int EncodedKeyCellLength(BaseSchema* schema, const RowView& row, int column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (std::is_arithmetic_v<T>) {
+    return dingo_schema->GetEncodedKeyLength(row.GetScalar<T>(column));
+  } else {
+    return dingo_schema->GetEncodedKeyLength(row, column);
+  }
+}
+
+template <typename T>
+int EncodedValueCellLength(BaseSchema* schema, const RowView& row, int column) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (std::is_arithmetic_v<T>) {
+    return dingo_schema->GetEncodedValueLength(row.GetScalar<T>(column));
+  } else {
+    return dingo_schema->GetEncodedValueLength(row, column);
+  }
+}
+
+// Rows of a column vector, scalars read into the optional overloads like the row cells.
+template <typename T>
+std::optional<T> VectorScalar(const ColumnVector& column, int row) {
+  if (column.IsNull(row)) {
+    return std::nullopt;
+  }
+  return column.Get<T>(row);
+}
+
+template <typename T, bool LE>
+void EncodeKeyVectorCell(BaseSchema* schema, Buf& buf, const ColumnVector& column, int row) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (!std::is_arithmetic_v<T>) {
+    dingo_schema->EncodeKey(&buf, column, row);
+  } else if constexpr (kFixedKeyByteOrder<T>) {
+    dingo_schema->template EncodeKey<LE>(&buf, VectorScalar<T>(column, row));
+  } else {
+    dingo_schema->EncodeKey(&buf, VectorScalar<T>(column, row));
+  }
+}
+
+template <typename T, bool LE>
+void EncodeValueVectorCell(BaseSchema* schema, Buf& buf, const ColumnVector& column, int row) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (!std::is_arithmetic_v<T>) {
+    if constexpr (kFixedValueByteOrder<T>) {
+      dingo_schema->template EncodeValue<LE>(&buf, column, row);
+    } else {
+      dingo_schema->EncodeValue(&buf, column, row);
+    }
+  } else if constexpr (kFixedValueByteOrder<T>) {
+    dingo_schema->template EncodeValue<LE>(&buf, VectorScalar<T>(column, row));
+  } else {
+    dingo_schema->EncodeValue(&buf, VectorScalar<T>(column, row));
+  }
+}
+
+template <typename T>
+int EncodedKeyVectorCellLength(BaseSchema* schema, const ColumnVector& column, int row) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (std::is_arithmetic_v<T>) {
+    return dingo_schema->GetEncodedKeyLength(VectorScalar<T>(column, row));
+  } else {
+    return dingo_schema->GetEncodedKeyLength(column, row);
+  }
+}
+
+template <typename T>
+int EncodedValueVectorCellLength(BaseSchema* schema, const ColumnVector& column, int row) {
+  auto* dingo_schema = static_cast<DingoSchema<std::optional<T>>*>(schema);
+  if constexpr (std::is_arithmetic_v<T>) {
+    return dingo_schema->GetEncodedValueLength(VectorScalar<T>(column, row));
+  } else {
+    return dingo_schema->GetEncodedValueLength(column, row);
+  }
+}
+
+template <typename T, bool LE>
+void BindKeyColumn(ColumnEncoder& column) {
+  column.encode = EncodeKeyColumn<T, LE>;
+  column.encode_prefix = EncodeKeyPrefixColumn<T, LE>;
+  column.encode_prefix_from_string = EncodeKeyPrefixColumnFromString<T, LE>;
+  column.encoded_length = EncodedKeyLength<T>;
+  column.encode_row = EncodeKeyCell<T, LE>;
+  column.encoded_row_length = EncodedKeyCellLength<T>;
+  column.encode_vector = EncodeKeyVectorCell<T, LE>;
+  column.encoded_vector_length = EncodedKeyVectorCellLength<T>;
+}
+
+template <typename T, bool LE>
+void BindValueColumn(ColumnEncoder& column) {
+  column.encode = EncodeValueColumn<T, LE>;
+  column.encoded_length = EncodedValueLength<T>;
+  column.encode_row = EncodeValueCell<T, LE>;
+  column.encoded_row_length = EncodedValueCellLength<T>;
+  column.encode_vector = EncodeValueVectorCell<T, LE>;
+  column.encoded_vector_length = EncodedValueVectorCellLength<T>;
+}
+
+template <bool LE>
+bool BindColumn(ColumnEncoder& column, BaseSchema::Type type, bool key) {
+  // List columns are never encoded into keys.
+  switch (type) {
+    case BaseSchema::kBool:
+      key ? BindKeyColumn<bool, LE>(column) : BindValueColumn<bool, LE>(column);
+      return true;
+    case BaseSchema::kInteger:
+      key ? BindKeyColumn<int32_t, LE>(column) : BindValueColumn<int32_t, LE>(column);
+      return true;
+    case BaseSchema::kFloat:
+      key ? BindKeyColumn<float, LE>(column) : BindValueColumn<float, LE>(column);
+      return true;
+    case BaseSchema::kLong:
+      key ? BindKeyColumn<int64_t, LE>(column) : BindValueColumn<int64_t, LE>(column);
+      return true;
+    case BaseSchema::kDouble:
+      key ? BindKeyColumn<double, LE>(column) : BindValueColumn<double, LE>(column);
+      return true;
+    case BaseSchema::kString:
+      key ? BindKeyColumn<std::shared_ptr<std::string>, LE>(column)
+          : BindValueColumn<std::shared_ptr<std::string>, LE>(column);
+      return true;
+    case BaseSchema::kBoolList:
+      BindValueColumn<std::shared_ptr<std::vector<bool>>, LE>(column);
+      return !key;
+    case BaseSchema::kIntegerList:
+      BindValueColumn<std::shared_ptr<std::vector<int32_t>>, LE>(column);
+      return !key;
+    case BaseSchema::kFloatList:
+      BindValueColumn<std::shared_ptr<std::vector<float>>, LE>(column);
+      return !key;
+    case BaseSchema::kLongList:
+      BindValueColumn<std::shared_ptr<std::vector<int64_t>>, LE>(column);
+      return !key;
+    case BaseSchema::kDoubleList:
+      BindValueColumn<std::shared_ptr<std::vector<double>>, LE>(column);
+      return !key;
+    case BaseSchema::kStringList:
+      BindValueColumn<std::shared_ptr<std::vector<std::string>>, LE>(column);
+      return !key;
+    default:
+      return false;
+  }
+}
+
+void RecordEncoder::CompilePlan() {
+  key_plan_.clear();
+  value_plan_.clear();
+  plan_.clear();
+  int position = 0;
+  int ordinal = 0;
+  for (const auto& bs : *schemas_) {
+    if (bs) {
+      ColumnEncoder column{};
+      column.schema = bs.get();
+      column.position = position;
+      column.ordinal = ordinal++;
+      column.index = bs->GetIndex();
+      column.type = bs->GetType();
+      column.fixed_length = -1;
+      column.key = bs->IsKey();
+      bool key = column.key;
+      BaseSchema::Type type = column.type;
+      if (le_ ? BindColumn<true>(column, type, key) : BindColumn<false>(column, type, key)) {
+        // Nullable fixed width columns always take their full length, with or without a value. A null bool key is
+        // the exception and only writes its tag.
+        if (bs->AllowNull() && type <= BaseSchema::kDouble && !(key && type == BaseSchema::kBool)) {
+          column.fixed_length = bs->GetLength();
+        }
+        (key ? key_plan_ : value_plan_).push_back(column);
+        plan_.push_back(column);
+      }
+    }
+    position++;
+  }
+}
+
+void RecordEncoder::EnableScratchBuffers(int max_retained_bytes) {
+  this->reuse_scratch_ = true;
+  this->max_retained_scratch_bytes_ = max_retained_bytes;
+}
+
+void RecordEncoder::DisableScratchBuffers() { this->reuse_scratch_ = false; }
+
+void RecordEncoder::SetThreadPool(std::shared_ptr<ThreadPool> pool, int min_parallel_rows) {
+  this->pool_ = pool;
+  this->min_parallel_rows_ = min_parallel_rows;
+}
+
+// One scratch buffer per thread, shared by all encoders that opted in. Encode calls do not nest, so a single buffer
+// is enough.
+static thread_local std::string scratch_buf;
+
+std::string RecordEncoder::TakeScratch() const {
+  if (!reuse_scratch_) {
+    return std::string();
+  }
+  return std::move(scratch_buf);
+}
+
+void RecordEncoder::GiveBackScratch(std::string&& scratch) const {
+  if (!reuse_scratch_ || static_cast<int>(scratch.capacity()) > max_retained_scratch_bytes_) {
+    return;
+  }
+  scratch_buf = std::move(scratch);
 }
 
 void RecordEncoder::EncodePrefix(Buf& buf, char prefix) const {
@@ -65,324 +359,404 @@ void RecordEncoder::EncodeReverseTag(Buf& buf) const {
 
 void RecordEncoder::EncodeSchemaVersion(Buf& buf) const { buf.WriteInt(schema_version_); }
 
-int RecordEncoder::Encode(char prefix, const std::vector<std::any>& record, std::string& key, std::string& value) {
-  int ret = EncodeKey(prefix, record, key);
-  if (ret < 0) {
-    return ret;
+static bool CheckColumn(const ColumnEncoder& /*column*/, const std::vector<std::any>& /*record*/, int /*slot*/) {
+  // std::any_cast and at() throw on a mismatch.
+  return true;
+}
+
+static bool CheckColumn(const ColumnEncoder& column, const RowView& row, int slot) {
+  return slot < row.Size() && (row.IsNull(slot) || row.GetType(slot) == column.type);
+}
+
+// Row row of a ColumnBatch checked by EncodeColumns, and the batch seen as a vector of them.
+struct ColumnBatchRow {
+  const ColumnBatch* columns;
+  int row;
+};
+
+struct ColumnBatchRows {
+  const ColumnBatch* columns;
+
+  int size() const { return columns->num_rows; }
+  ColumnBatchRow operator[](int row) const { return ColumnBatchRow{columns, row}; }
+};
+
+static bool CheckColumn(const ColumnEncoder& /*column*/, const ColumnBatchRow& /*record*/, int /*slot*/) {
+  // The column types are checked once per batch.
+  return true;
+}
+
+static int EncodedColumnLength(const ColumnEncoder& column, const std::vector<std::any>& record, int slot) {
+  return column.encoded_length(column.schema, record.at(slot));
+}
+
+static int EncodedColumnLength(const ColumnEncoder& column, const RowView& row, int slot) {
+  return column.encoded_row_length(column.schema, row, slot);
+}
+
+static int EncodedColumnLength(const ColumnEncoder& column, const ColumnBatchRow& record, int slot) {
+  return column.encoded_vector_length(column.schema, record.columns->columns[slot], record.row);
+}
+
+static void EncodeColumn(const ColumnEncoder& column, Buf& buf, const std::vector<std::any>& record, int slot) {
+  column.encode(column.schema, buf, record.at(slot));
+}
+
+static void EncodeColumn(const ColumnEncoder& column, Buf& buf, const RowView& row, int slot) {
+  column.encode_row(column.schema, buf, row, slot);
+}
+
+static void EncodeColumn(const ColumnEncoder& column, Buf& buf, const ColumnBatchRow& record, int slot) {
+  column.encode_vector(column.schema, buf, record.columns->columns[slot], record.row);
+}
+
+template <typename Record>
+int RecordEncoder::InternalEncodedKeySize(const Record& record) const {
+  // |namespace|id| ... |tag|
+  int size = 13;
+  for (const auto& column : key_plan_) {
+    if (!CheckColumn(column, record, column.position)) {
+      //"Wrong Column Type"
+      return -1;
+    }
+    size += column.fixed_length >= 0 ? column.fixed_length : EncodedColumnLength(column, record, column.position);
   }
-  ret = EncodeValue(record, value);
-  if (ret < 0) {
-    return ret;
+  return size;
+}
+
+template <typename Record>
+int RecordEncoder::InternalEncodedValueSize(const Record& record) const {
+  // |schema version| ...
+  int size = 4;
+  for (const auto& column : value_plan_) {
+    if (!CheckColumn(column, record, column.index)) {
+      //"Wrong Column Type"
+      return -1;
+    }
+    size += column.fixed_length >= 0 ? column.fixed_length : EncodedColumnLength(column, record, column.index);
   }
-  return 0;
+  return size;
 }
 
-int RecordEncoder::EncodeKey(char prefix, const std::vector<std::any>& record, std::string& output) {
-  Buf buf(key_buf_size_, this->le_);
+template <typename Record>
+int RecordEncoder::InternalEncodeKey(char prefix, const Record& record, OutputSink& output) const {
+  int size = InternalEncodedKeySize(record);
+  if (size < 0) {
+    return -1;
+  }
+  char* data = output.Reserve(size);
+  if (data == nullptr) {
+    return -1;
+  }
+  if (InternalEncodeKey(prefix, record, data, size) < 0) {
+    output.Unreserve(size);
+    return -1;
+  }
+  return size;
+}
+
+template <typename Record>
+int RecordEncoder::InternalEncodeKey(char prefix, const Record& record, char* data, int size) const {
+  Buf buf(data, size, this->le_);
   // |namespace|id| ... |tag|
-  buf.EnsureRemainder(13);
   EncodePrefix(buf, prefix);
   EncodeReverseTag(buf);
-  int index = 0;
-  for (const auto& bs : *schemas_) {
-    if (bs) {
-      BaseSchema::Type type = bs->GetType();
-      switch (type) {
-        case BaseSchema::kBool: {
-          auto bos = std::dynamic_pointer_cast<DingoSchema<std::optional<bool>>>(bs);
-          if (bos->IsKey()) {
-            bos->EncodeKey(&buf, std::any_cast<std::optional<bool>>(record.at(index)));
-          }
-          break;
-        }
-        case BaseSchema::kInteger: {
-          auto is = std::dynamic_pointer_cast<DingoSchema<std::optional<int32_t>>>(bs);
-          if (is->IsKey()) {
-            is->EncodeKey(&buf, std::any_cast<std::optional<int32_t>>(record.at(index)));
-          }
-          break;
-        }
-        case BaseSchema::kFloat: {
-          auto fs = std::dynamic_pointer_cast<DingoSchema<std::optional<float>>>(bs);
-          if (fs->IsKey()) {
-            fs->EncodeKey(&buf, std::any_cast<std::optional<float>>(record.at(index)));
-          }
-          break;
-        }
-        case BaseSchema::kLong: {
-          auto ls = std::dynamic_pointer_cast<DingoSchema<std::optional<int64_t>>>(bs);
-          if (ls->IsKey()) {
-            ls->EncodeKey(&buf, std::any_cast<std::optional<int64_t>>(record.at(index)));
-          }
-          break;
-        }
-        case BaseSchema::kDouble: {
-          auto ds = std::dynamic_pointer_cast<DingoSchema<std::optional<double>>>(bs);
-          if (ds->IsKey()) {
-            ds->EncodeKey(&buf, std::any_cast<std::optional<double>>(record.at(index)));
-          }
-          break;
-        }
-        case BaseSchema::kString: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::string>>>>(bs);
-          if (ss->IsKey()) {
-            ss->EncodeKey(&buf, std::any_cast<std::optional<std::shared_ptr<std::string>>>(record.at(index)));
-          }
-          break;
-        }
-        default: {
-          break;
-        }
-      }
-    }
-    index++;
+  for (const auto& column : key_plan_) {
+    EncodeColumn(column, buf, record, column.position);
   }
 
-  return buf.GetBytes(output);
+  if (!buf.IsFilled(data)) {
+    //"Wrong Encoded Size"
+    return -1;
+  }
+  return size;
+}
+
+template <typename Record>
+int RecordEncoder::InternalEncodeValue(const Record& record, OutputSink& output) const {
+  int size = InternalEncodedValueSize(record);
+  if (size < 0) {
+    return -1;
+  }
+  char* data = output.Reserve(size);
+  if (data == nullptr) {
+    return -1;
+  }
+  if (InternalEncodeValue(record, data, size) < 0) {
+    output.Unreserve(size);
+    return -1;
+  }
+  return size;
 }
 
-int RecordEncoder::EncodeValue(const std::vector<std::any>& record, std::string& output) {
-  Buf buf(value_buf_size_, this->le_);
-  buf.EnsureRemainder(4);
+template <typename Record>
+int RecordEncoder::InternalEncodeValue(const Record& record, char* data, int size) const {
+  Buf buf(data, size, this->le_);
   EncodeSchemaVersion(buf);
+  for (const auto& column : value_plan_) {
+    EncodeColumn(column, buf, record, column.index);
+  }
 
-  for (const auto& bs : *schemas_) {
-    if (bs) {
-      BaseSchema::Type type = bs->GetType();
-      switch (type) {
-        case BaseSchema::kBool: {
-          auto bos = std::dynamic_pointer_cast<DingoSchema<std::optional<bool>>>(bs);
-          if (!bos->IsKey()) {
-            bos->EncodeValue(&buf, std::any_cast<std::optional<bool>>(record.at(bos->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kInteger: {
-          auto is = std::dynamic_pointer_cast<DingoSchema<std::optional<int32_t>>>(bs);
-          if (!is->IsKey()) {
-            is->EncodeValue(&buf, std::any_cast<std::optional<int32_t>>(record.at(is->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kFloat: {
-          auto fs = std::dynamic_pointer_cast<DingoSchema<std::optional<float>>>(bs);
-          if (!fs->IsKey()) {
-            fs->EncodeValue(&buf, std::any_cast<std::optional<float>>(record.at(fs->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kLong: {
-          auto ls = std::dynamic_pointer_cast<DingoSchema<std::optional<int64_t>>>(bs);
-          if (!ls->IsKey()) {
-            ls->EncodeValue(&buf, std::any_cast<std::optional<int64_t>>(record.at(ls->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kDouble: {
-          auto ds = std::dynamic_pointer_cast<DingoSchema<std::optional<double>>>(bs);
-          if (!ds->IsKey()) {
-            ds->EncodeValue(&buf, std::any_cast<std::optional<double>>(record.at(ds->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kString: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::string>>>>(bs);
-          if (!ss->IsKey()) {
-            ss->EncodeValue(&buf,
-                            std::any_cast<std::optional<std::shared_ptr<std::string>>>(record.at(ss->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kBoolList: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>>(bs);
-          if (!ss->IsKey()) {
-            ss->EncodeValue(
-                &buf, std::any_cast<std::optional<std::shared_ptr<std::vector<bool>>>>(record.at(ss->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kStringList: {
-          auto ss =
-              std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>>(bs);
-          if (!ss->IsKey()) {
-            ss->EncodeValue(&buf, std::any_cast<std::optional<std::shared_ptr<std::vector<std::string>>>>(
-                                      record.at(ss->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kDoubleList: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>>(bs);
-          if (!ss->IsKey()) {
-            ss->EncodeValue(
-                &buf, std::any_cast<std::optional<std::shared_ptr<std::vector<double>>>>(record.at(ss->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kFloatList: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>>(bs);
-          if (!ss->IsKey()) {
-            ss->EncodeValue(
-                &buf, std::any_cast<std::optional<std::shared_ptr<std::vector<float>>>>(record.at(ss->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kIntegerList: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>>(bs);
-          if (!ss->IsKey()) {
-            ss->EncodeValue(
-                &buf, std::any_cast<std::optional<std::shared_ptr<std::vector<int32_t>>>>(record.at(ss->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kLongList: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>>(bs);
-          if (!ss->IsKey()) {
-            ss->EncodeValue(
-                &buf, std::any_cast<std::optional<std::shared_ptr<std::vector<int64_t>>>>(record.at(ss->GetIndex())));
-          }
-          break;
-        }
-        default: {
-          break;
-        }
-      }
+  if (!buf.IsFilled(data)) {
+    //"Wrong Encoded Size"
+    return -1;
+  }
+  return size;
+}
+
+template <typename Record>
+bool RecordEncoder::InternalEncodedSize(const Record& record, int& key_size, int& value_size) const {
+  // |namespace|id| ... |tag| and |schema version| ...
+  key_size = 13;
+  value_size = 4;
+  for (const auto& column : plan_) {
+    int slot = column.key ? column.position : column.index;
+    if (!CheckColumn(column, record, slot)) {
+      //"Wrong Column Type"
+      return false;
     }
+    (column.key ? key_size : value_size) +=
+        column.fixed_length >= 0 ? column.fixed_length : EncodedColumnLength(column, record, slot);
   }
+  return true;
+}
 
-  return buf.GetBytes(output);
+template <typename Record>
+int RecordEncoder::InternalEncode(char prefix, const Record& record, OutputSink& key, OutputSink& value) const {
+  int key_size;
+  int value_size;
+  if (!InternalEncodedSize(record, key_size, value_size)) {
+    return -1;
+  }
+  // A second Reserve on the same sink may move the first region, so a shared sink hands out both at once.
+  bool shared = &key == &value;
+  char* key_data = key.Reserve(shared ? key_size + value_size : key_size);
+  if (key_data == nullptr) {
+    return -1;
+  }
+  char* value_data = shared ? key_data + key_size : value.Reserve(value_size);
+  if (value_data == nullptr) {
+    key.Unreserve(key_size);
+    return -1;
+  }
+  if (InternalEncode(prefix, record, key_data, key_size, value_data, value_size) < 0) {
+    if (shared) {
+      key.Unreserve(key_size + value_size);
+    } else {
+      value.Unreserve(value_size);
+      key.Unreserve(key_size);
+    }
+    return -1;
+  }
+  return 0;
 }
 
-int RecordEncoder::EncodeKeyPrefix(char prefix, const std::vector<std::any>& record, int column_count,
-                                   std::string& output) {
-  Buf buf(key_buf_size_, this->le_);
-  buf.EnsureRemainder(9);
-  EncodePrefix(buf, prefix);
-  for (const auto& bs : *schemas_) {
-    if (bs) {
-      BaseSchema::Type type = bs->GetType();
-      switch (type) {
-        case BaseSchema::kBool: {
-          auto bos = std::dynamic_pointer_cast<DingoSchema<std::optional<bool>>>(bs);
-          if (bos->IsKey()) {
-            bos->EncodeKeyPrefix(&buf, std::any_cast<std::optional<bool>>(record.at(bos->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kInteger: {
-          auto is = std::dynamic_pointer_cast<DingoSchema<std::optional<int32_t>>>(bs);
-          if (is->IsKey()) {
-            is->EncodeKeyPrefix(&buf, std::any_cast<std::optional<int32_t>>(record.at(is->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kFloat: {
-          auto fs = std::dynamic_pointer_cast<DingoSchema<std::optional<float>>>(bs);
-          if (fs->IsKey()) {
-            fs->EncodeKeyPrefix(&buf, std::any_cast<std::optional<float>>(record.at(fs->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kLong: {
-          auto ls = std::dynamic_pointer_cast<DingoSchema<std::optional<int64_t>>>(bs);
-          if (ls->IsKey()) {
-            ls->EncodeKeyPrefix(&buf, std::any_cast<std::optional<int64_t>>(record.at(ls->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kDouble: {
-          auto ds = std::dynamic_pointer_cast<DingoSchema<std::optional<double>>>(bs);
-          if (ds->IsKey()) {
-            ds->EncodeKeyPrefix(&buf, std::any_cast<std::optional<double>>(record.at(ds->GetIndex())));
-          }
-          break;
-        }
-        case BaseSchema::kString: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::string>>>>(bs);
-          if (ss->IsKey()) {
-            ss->EncodeKeyPrefix(&buf,
-                                std::any_cast<std::optional<std::shared_ptr<std::string>>>(record.at(ss->GetIndex())));
-          }
-          break;
-        }
-        default: {
-          break;
-        }
+template <typename Record>
+int RecordEncoder::InternalEncode(char prefix, const Record& record, char* key_data, int key_size, char* value_data,
+                                  int value_size) const {
+  Buf key_buf(key_data, key_size, this->le_);
+  Buf value_buf(value_data, value_size, this->le_);
+  EncodePrefix(key_buf, prefix);
+  EncodeReverseTag(key_buf);
+  EncodeSchemaVersion(value_buf);
+  for (const auto& column : plan_) {
+    if (column.key) {
+      EncodeColumn(column, key_buf, record, column.position);
+    } else {
+      EncodeColumn(column, value_buf, record, column.index);
+    }
+  }
+
+  if (!key_buf.IsFilled(key_data) || !value_buf.IsFilled(value_data)) {
+    //"Wrong Encoded Size"
+    return -1;
+  }
+  return 0;
+}
+
+template <typename Records>
+int RecordEncoder::InternalEncodeBatch(char prefix, const Records& records, EncodedBatch& batch) const {
+  batch.Clear();
+  int count = records.size();
+  batch.key_offsets.resize(count + 1);
+  batch.value_offsets.resize(count + 1);
+  std::atomic<bool> failed{false};
+
+  // Every record sizes itself into its end offset, the running sums then place the records one after another.
+  ParallelFor(pool_.get(), count, min_parallel_rows_, [&](int begin, int end) {
+    for (int i = begin; i < end && !failed; i++) {
+      int key_size;
+      int value_size;
+      if (!InternalEncodedSize(records[i], key_size, value_size)) {
+        failed = true;
       }
+      batch.key_offsets[i + 1] = key_size;
+      batch.value_offsets[i + 1] = value_size;
     }
+  });
+  if (failed) {
+    batch.Clear();
+    return -1;
+  }
+  for (int i = 0; i < count; i++) {
+    batch.key_offsets[i + 1] += batch.key_offsets[i];
+    batch.value_offsets[i + 1] += batch.value_offsets[i];
+  }
+  batch.keys.resize(batch.key_offsets.back());
+  batch.values.resize(batch.value_offsets.back());
 
-    if (--column_count <= 0) {
-      break;
+  ParallelFor(pool_.get(), count, min_parallel_rows_, [&](int begin, int end) {
+    for (int i = begin; i < end && !failed; i++) {
+      int64_t key_offset = batch.key_offsets[i];
+      int64_t value_offset = batch.value_offsets[i];
+      if (InternalEncode(prefix, records[i], batch.keys.data() + key_offset, batch.key_offsets[i + 1] - key_offset,
+                         batch.values.data() + value_offset, batch.value_offsets[i + 1] - value_offset) < 0) {
+        failed = true;
+      }
     }
+  });
+  if (failed) {
+    batch.Clear();
+    return -1;
   }
+  return count;
+}
+
+int RecordEncoder::EncodedKeySize(const std::vector<std::any>& record) const { return InternalEncodedKeySize(record); }
+
+int RecordEncoder::EncodedValueSize(const std::vector<std::any>& record) const {
+  return InternalEncodedValueSize(record);
+}
+
+int RecordEncoder::EncodedKeySize(const RowView& row) const { return InternalEncodedKeySize(row); }
+
+int RecordEncoder::EncodedValueSize(const RowView& row) const { return InternalEncodedValueSize(row); }
+
+int RecordEncoder::Encode(char prefix, const std::vector<std::any>& record, std::string& key,
+                          std::string& value) const {
+  key.clear();
+  value.clear();
+  StringSink key_sink(&key);
+  StringSink value_sink(&value);
+  return Encode(prefix, record, key_sink, value_sink);
+}
+
+int RecordEncoder::Encode(char prefix, const std::vector<std::any>& record, OutputSink& key, OutputSink& value) const {
+  return InternalEncode(prefix, record, key, value);
+}
+
+int RecordEncoder::EncodeKey(char prefix, const std::vector<std::any>& record, std::string& output) const {
+  output.clear();
+  StringSink sink(&output);
+  return EncodeKey(prefix, record, sink);
+}
+
+int RecordEncoder::EncodeKey(char prefix, const std::vector<std::any>& record, OutputSink& output) const {
+  return InternalEncodeKey(prefix, record, output);
+}
+
+int RecordEncoder::EncodeValue(const std::vector<std::any>& record, std::string& output) const {
+  output.clear();
+  StringSink sink(&output);
+  return EncodeValue(record, sink);
+}
+
+int RecordEncoder::EncodeValue(const std::vector<std::any>& record, OutputSink& output) const {
+  return InternalEncodeValue(record, output);
+}
+
+int RecordEncoder::Encode(char prefix, const RowView& row, std::string& key, std::string& value) const {
+  key.clear();
+  value.clear();
+  StringSink key_sink(&key);
+  StringSink value_sink(&value);
+  return Encode(prefix, row, key_sink, value_sink);
+}
+
+int RecordEncoder::Encode(char prefix, const RowView& row, OutputSink& key, OutputSink& value) const {
+  return InternalEncode(prefix, row, key, value);
+}
+
+int RecordEncoder::EncodeKey(char prefix, const RowView& row, std::string& output) const {
+  output.clear();
+  StringSink sink(&output);
+  return EncodeKey(prefix, row, sink);
+}
+
+int RecordEncoder::EncodeKey(char prefix, const RowView& row, OutputSink& output) const {
+  return InternalEncodeKey(prefix, row, output);
+}
+
+int RecordEncoder::EncodeValue(const RowView& row, std::string& output) const {
+  output.clear();
+  StringSink sink(&output);
+  return EncodeValue(row, sink);
+}
 
-  return buf.GetBytes(output);
+int RecordEncoder::EncodeValue(const RowView& row, OutputSink& output) const {
+  return InternalEncodeValue(row, output);
 }
 
-int RecordEncoder::EncodeKeyPrefix(char prefix, const std::vector<std::string>& keys, std::string& output) {
-  Buf buf(key_buf_size_, this->le_);
+int RecordEncoder::EncodeBatch(char prefix, const std::vector<std::vector<std::any>>& records,
+                               EncodedBatch& batch) const {
+  return InternalEncodeBatch(prefix, records, batch);
+}
+
+int RecordEncoder::EncodeBatch(char prefix, const std::vector<Row>& rows, EncodedBatch& batch) const {
+  return InternalEncodeBatch(prefix, rows, batch);
+}
+
+int RecordEncoder::EncodeBatch(char prefix, const std::vector<RowView>& rows, EncodedBatch& batch) const {
+  return InternalEncodeBatch(prefix, rows, batch);
+}
+
+int RecordEncoder::EncodeColumns(char prefix, const ColumnBatch& columns, EncodedBatch& batch) const {
+  for (const auto& column : plan_) {
+    int slot = column.key ? column.position : column.index;
+    if (slot >= static_cast<int>(columns.columns.size()) || columns.columns[slot].type != column.type ||
+        columns.columns[slot].size < columns.num_rows) {
+      //"Wrong Column Type"
+      batch.Clear();
+      return -1;
+    }
+  }
+  return InternalEncodeBatch(prefix, ColumnBatchRows{&columns}, batch);
+}
+
+int RecordEncoder::EncodeKeyPrefix(char prefix, const std::vector<std::any>& record, int column_count,
+                                   std::string& output) const {
+  Buf buf(TakeScratch(), key_buf_size_, this->le_);
   buf.EnsureRemainder(9);
   EncodePrefix(buf, prefix);
-  unsigned long i = 0;
-  for (const auto& bs : *schemas_) {
-    if (i == keys.size()) {
+  // The first schema is always taken, even with a column_count of zero.
+  int end = std::max(column_count, 1);
+  for (const auto& column : key_plan_) {
+    if (column.position >= end) {
       break;
     }
-    if (bs) {
-      BaseSchema::Type type = bs->GetType();
-      switch (type) {
-        case BaseSchema::kBool: {
-          auto bos = std::dynamic_pointer_cast<DingoSchema<std::optional<bool>>>(bs);
-          if (bos->IsKey()) {
-            bos->EncodeKeyPrefix(&buf, std::optional<bool>(StringToBool(keys[i])));
-          }
-          break;
-        }
-        case BaseSchema::kInteger: {
-          auto is = std::dynamic_pointer_cast<DingoSchema<std::optional<int32_t>>>(bs);
-          if (is->IsKey()) {
-            is->EncodeKeyPrefix(&buf, std::optional<int32_t>(StringToBool(keys[i])));
-          }
-          break;
-        }
-        case BaseSchema::kFloat: {
-          auto fs = std::dynamic_pointer_cast<DingoSchema<std::optional<float>>>(bs);
-          if (fs->IsKey()) {
-            fs->EncodeKeyPrefix(&buf, std::optional<float>(StringToBool(keys[i])));
-          }
-          break;
-        }
-        case BaseSchema::kLong: {
-          auto ls = std::dynamic_pointer_cast<DingoSchema<std::optional<int64_t>>>(bs);
-          if (ls->IsKey()) {
-            ls->EncodeKeyPrefix(&buf, std::optional<int64_t>(StringToBool(keys[i])));
-          }
-          break;
-        }
-        case BaseSchema::kDouble: {
-          auto ds = std::dynamic_pointer_cast<DingoSchema<std::optional<double>>>(bs);
-          if (ds->IsKey()) {
-            ds->EncodeKeyPrefix(&buf, std::optional<double>(StringToBool(keys[i])));
-          }
-          break;
-        }
-        case BaseSchema::kString: {
-          auto ss = std::dynamic_pointer_cast<DingoSchema<std::optional<std::shared_ptr<std::string>>>>(bs);
-          if (ss->IsKey()) {
-            ss->EncodeKeyPrefix(&buf,
-                                std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(keys[i])));
-          }
-          break;
-        }
-        default: {
-          break;
-        }
-      }
+    column.encode_prefix(column.schema, buf, record.at(column.index));
+  }
 
-      ++i;
+  int ret = buf.GetBytes(output);
+  GiveBackScratch(buf.Release());
+  return ret;
+}
+
+int RecordEncoder::EncodeKeyPrefix(char prefix, const std::vector<std::string>& keys, std::string& output) const {
+  Buf buf(TakeScratch(), key_buf_size_, this->le_);
+  buf.EnsureRemainder(9);
+  EncodePrefix(buf, prefix);
+  // keys line up with the non-null schemas, value columns included.
+  for (const auto& column : key_plan_) {
+    if (column.ordinal >= static_cast<int>(keys.size())) {
+      break;
     }
+    column.encode_prefix_from_string(column.schema, buf, keys[column.ordinal]);
   }
 
-  return buf.GetBytes(output);
+  int ret = buf.GetBytes(output);
+  GiveBackScratch(buf.Release());
+  return ret;
 }
 
 int RecordEncoder::EncodeMaxKeyPrefix(char prefix, std::string& output) const {
@@ -390,20 +764,19 @@ int RecordEncoder::EncodeMaxKeyPrefix(char prefix, std::string& output) const {
     return -1;
   }
 
-  Buf buf(key_buf_size_, this->le_);
-  buf.EnsureRemainder(9);
+  output.resize(9);
+  Buf buf(output.data(), 9, this->le_);
   buf.Write(prefix);
   buf.WriteLong(common_id_ + 1);
-  return buf.GetBytes(output);
+  return 9;
 }
 
 int RecordEncoder::EncodeMinKeyPrefix(char prefix, std::string& output) const {
-  Buf buf(key_buf_size_, this->le_);
-  buf.EnsureRemainder(9);
+  output.resize(9);
+  Buf buf(output.data(), 9, this->le_);
   buf.Write(prefix);
   buf.WriteLong(common_id_);
-
-  return buf.GetBytes(output);
+  return 9;
 }
 
 }  // namespace dingodb
@@ -21,7 +21,11 @@
 #include "any"
 #include "functional"         // IWYU pragma: keep
 #include "optional"           // IWYU pragma: keep
+#include "serial/column_batch.h"
+#include "serial/encoded_batch.h"
 #include "serial/keyvalue.h"  // IWYU pragma: keep
+#include "serial/output_sink.h"
+#include "serial/row.h"
 #include "serial/schema/boolean_list_schema.h"
 #include "serial/schema/boolean_schema.h"  // IWYU pragma: keep
 #include "serial/schema/double_list_schema.h"
@@ -34,39 +38,152 @@
 #include "serial/schema/long_schema.h"  // IWYU pragma: keep
 #include "serial/schema/string_list_schema.h"
 #include "serial/schema/string_schema.h"  // IWYU pragma: keep
-#include "serial/utils.h"                 // IWYU pragma: keep
+#include "serial/thread_pool.h"
+#include "serial/utils.h"  // IWYU pragma: keep
 
 namespace dingodb {
 
+// One column of the encode plan, compiled from the schemas in Init. The functions are bound to the concrete schema
+// type and the codec byte order, so the per-row loops neither cast nor touch the schema shared_ptrs.
+struct ColumnEncoder {
+  BaseSchema* schema;
+  // Place in the schema vector, among the non-null schemas, and in the record.
+  int position;
+  int ordinal;
+  int index;
+  BaseSchema::Type type;
+  // Key column, read from the record at position, otherwise a value column read at index.
+  bool key;
+  // Encoded length when it does not depend on the datum, -1 otherwise.
+  int fixed_length;
+  void (*encode)(BaseSchema* schema, Buf& buf, const std::any& column);
+  void (*encode_prefix)(BaseSchema* schema, Buf& buf, const std::any& column);
+  void (*encode_prefix_from_string)(BaseSchema* schema, Buf& buf, const std::string& column);
+  int (*encoded_length)(BaseSchema* schema, const std::any& column);
+  // Same for a cell of a typed row.
+  void (*encode_row)(BaseSchema* schema, Buf& buf, const RowView& row, int column);
+  int (*encoded_row_length)(BaseSchema* schema, const RowView& row, int column);
+  // Same for a row of a column vector.
+  void (*encode_vector)(BaseSchema* schema, Buf& buf, const ColumnVector& column, int row);
+  int (*encoded_vector_length)(BaseSchema* schema, const ColumnVector& column, int row);
+};
+
+// The byte order and the column plan are fixed by Init, the schemas are only read and never modified, so codecs of
+// either byte order can share one schema vector. Once configured, a RecordEncoder is safe to share across threads: the
+// const encode calls may run concurrently, Init and the Set/Enable calls must not overlap with them.
 class RecordEncoder {
  private:
   void EncodePrefix(Buf& buf, char prefix) const;
   void EncodeReverseTag(Buf& buf) const;
   void EncodeSchemaVersion(Buf& buf) const;
+  std::string TakeScratch() const;
+  void GiveBackScratch(std::string&& scratch) const;
+
+  void CompilePlan();
+
+  // Shared by the std::any records and the typed rows.
+  template <typename Record>
+  int InternalEncodedKeySize(const Record& record) const;
+  template <typename Record>
+  int InternalEncodedValueSize(const Record& record) const;
+  template <typename Record>
+  int InternalEncodeKey(char prefix, const Record& record, OutputSink& output) const;
+  template <typename Record>
+  int InternalEncodeValue(const Record& record, OutputSink& output) const;
+  // Fill exactly size bytes at data, size comes from InternalEncoded*Size.
+  template <typename Record>
+  int InternalEncodeKey(char prefix, const Record& record, char* data, int size) const;
+  template <typename Record>
+  int InternalEncodeValue(const Record& record, char* data, int size) const;
+  // Key and value together, visiting every column once in schema order.
+  template <typename Record>
+  bool InternalEncodedSize(const Record& record, int& key_size, int& value_size) const;
+  template <typename Record>
+  int InternalEncode(char prefix, const Record& record, OutputSink& key, OutputSink& value) const;
+  template <typename Record>
+  int InternalEncode(char prefix, const Record& record, char* key_data, int key_size, char* value_data,
+                     int value_size) const;
+  // Records is indexable and sized like a std::vector of records.
+  template <typename Records>
+  int InternalEncodeBatch(char prefix, const Records& records, EncodedBatch& batch) const;
 
   uint8_t codec_version_ = 1;
   int schema_version_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas_;
   long common_id_;
   int key_buf_size_;
-  int value_buf_size_;
+  std::vector<ColumnEncoder> key_plan_;
+  std::vector<ColumnEncoder> value_plan_;
+  // Key and value columns interleaved as in the schemas.
+  std::vector<ColumnEncoder> plan_;
   bool le_;
+  bool reuse_scratch_ = false;
+  int max_retained_scratch_bytes_ = kDefaultMaxRetainedScratchBytes;
+  std::shared_ptr<ThreadPool> pool_;
+  int min_parallel_rows_ = kDefaultMinParallelRows;
 
  public:
+  static constexpr int kDefaultMaxRetainedScratchBytes = 64 * 1024;
+  static constexpr int kDefaultMinParallelRows = 1024;
+
   RecordEncoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
   RecordEncoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id,
                 bool le);
 
   void Init(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
 
-  int Encode(char prefix, const std::vector<std::any>& record, std::string& key, std::string& value);
-
-  int EncodeKey(char prefix, const std::vector<std::any>& record, std::string& output);
-
-  int EncodeValue(const std::vector<std::any>& record, std::string& output);
-
-  int EncodeKeyPrefix(char prefix, const std::vector<std::any>& record, int column_count, std::string& output);
-  int EncodeKeyPrefix(char prefix, const std::vector<std::string>& keys, std::string& output);
+  // Opt in to reusing a per-thread scratch buffer for the encodes that still need one. Encode, EncodeKey, EncodeValue
+  // and EncodeBatch size their output exactly and write it in place, so they allocate no temporary to reuse. Only the
+  // key prefix encoders, whose length is known once encoded, build into a scratch buffer. The buffer keeps its
+  // high-water capacity between calls and is released once it grows beyond max_retained_bytes.
+  void EnableScratchBuffers(int max_retained_bytes = kDefaultMaxRetainedScratchBytes);
+  void DisableScratchBuffers();
+
+  // Spread EncodeBatch over pool once a batch has at least min_parallel_rows records, smaller batches and a null
+  // pool encode on the calling thread. The output does not depend on the pool.
+  void SetThreadPool(std::shared_ptr<ThreadPool> pool, int min_parallel_rows = kDefaultMinParallelRows);
+
+  int Encode(char prefix, const std::vector<std::any>& record, std::string& key, std::string& value) const;
+
+  int EncodeKey(char prefix, const std::vector<std::any>& record, std::string& output) const;
+
+  int EncodeValue(const std::vector<std::any>& record, std::string& output) const;
+
+  // Encode in one pass into the sinks, without an intermediate buffer. Key and value are appended to whatever the
+  // sinks already hold. EncodeKey/EncodeValue return the number of bytes written, or -1. Encode visits every column
+  // once for both. On failure every sink is left as it was, reserved bytes are given back.
+  int Encode(char prefix, const std::vector<std::any>& record, OutputSink& key, OutputSink& value) const;
+  int EncodeKey(char prefix, const std::vector<std::any>& record, OutputSink& output) const;
+  int EncodeValue(const std::vector<std::any>& record, OutputSink& output) const;
+
+  // Exact lengths of the key and value Encode produces for record, EncodeKey and EncodeValue allocate them once.
+  int EncodedKeySize(const std::vector<std::any>& record) const;
+  int EncodedValueSize(const std::vector<std::any>& record) const;
+
+  // Typed rows, indexed like the std::any records. A non-null cell whose type differs from its column, or a row too
+  // short for the schemas, fails the encode with -1.
+  int Encode(char prefix, const RowView& row, std::string& key, std::string& value) const;
+  int EncodeKey(char prefix, const RowView& row, std::string& output) const;
+  int EncodeValue(const RowView& row, std::string& output) const;
+  int Encode(char prefix, const RowView& row, OutputSink& key, OutputSink& value) const;
+  int EncodeKey(char prefix, const RowView& row, OutputSink& output) const;
+  int EncodeValue(const RowView& row, OutputSink& output) const;
+  int EncodedKeySize(const RowView& row) const;
+  int EncodedValueSize(const RowView& row) const;
+
+  // Encode every record of a batch, the keys into batch.keys and the values into batch.values. Both arenas are sized
+  // once for the whole batch and written in place. Returns the number of records, or -1 with batch cleared.
+  int EncodeBatch(char prefix, const std::vector<std::vector<std::any>>& records, EncodedBatch& batch) const;
+  int EncodeBatch(char prefix, const std::vector<Row>& rows, EncodedBatch& batch) const;
+  int EncodeBatch(char prefix, const std::vector<RowView>& rows, EncodedBatch& batch) const;
+  // Same from columns, columns.columns[i] holding column i of the records, the layout RecordDecoder::DecodeBatch
+  // produces for a projection of every column in index order. The column types are checked once for the batch, and
+  // each column is read through functions bound to its type, without a record per row. A column of another type, or
+  // shorter than columns.num_rows, fails the batch with -1.
+  int EncodeColumns(char prefix, const ColumnBatch& columns, EncodedBatch& batch) const;
+
+  int EncodeKeyPrefix(char prefix, const std::vector<std::any>& record, int column_count, std::string& output) const;
+  int EncodeKeyPrefix(char prefix, const std::vector<std::string>& keys, std::string& output) const;
 
   int EncodeMaxKeyPrefix(char prefix, std::string& output) const;
 
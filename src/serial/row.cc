@@ -0,0 +1,337 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/row.h"
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace dingodb {
+
+template <typename T>
+constexpr BaseSchema::Type kListType = std::is_same_v<T, bool>      ? BaseSchema::kBoolList
+                                       : std::is_same_v<T, int32_t> ? BaseSchema::kIntegerList
+                                       : std::is_same_v<T, float>   ? BaseSchema::kFloatList
+                                       : std::is_same_v<T, int64_t> ? BaseSchema::kLongList
+                                                                    : BaseSchema::kDoubleList;
+
+static int ListElementWidth(BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kBoolList:
+      return sizeof(bool);
+    case BaseSchema::kIntegerList:
+    case BaseSchema::kFloatList:
+      return 4;
+    case BaseSchema::kLongList:
+    case BaseSchema::kDoubleList:
+      return 8;
+    case BaseSchema::kStringList:
+      return sizeof(RowView::Span);
+    default:
+      return 0;
+  }
+}
+
+RowView::RowView(const Cell* cells, int size, const char* arena) : cells_(cells), size_(size), arena_(arena) {}
+
+int RowView::Size() const { return this->size_; }
+
+bool RowView::IsNull(int column) const { return cells_[column].null; }
+
+BaseSchema::Type RowView::GetType(int column) const { return cells_[column].type; }
+
+bool RowView::GetBool(int column) const { return cells_[column].b; }
+
+int32_t RowView::GetInt(int column) const { return cells_[column].i; }
+
+float RowView::GetFloat(int column) const { return cells_[column].f; }
+
+int64_t RowView::GetLong(int column) const { return cells_[column].l; }
+
+double RowView::GetDouble(int column) const { return cells_[column].d; }
+
+template <typename T>
+std::optional<T> RowView::GetScalar(int column) const {
+  const Cell& cell = cells_[column];
+  if (cell.null) {
+    return std::nullopt;
+  }
+  if constexpr (std::is_same_v<T, bool>) {
+    return cell.b;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return cell.i;
+  } else if constexpr (std::is_same_v<T, float>) {
+    return cell.f;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return cell.l;
+  } else {
+    return cell.d;
+  }
+}
+
+std::string_view RowView::GetString(int column) const {
+  const Span& span = cells_[column].span;
+  return std::string_view(arena_ + span.offset, span.size);
+}
+
+int RowView::GetListSize(int column) const { return cells_[column].span.size; }
+
+template <typename T>
+T RowView::GetListElement(int column, int element) const {
+  // Arena payloads are not aligned.
+  T data;
+  memcpy(&data, arena_ + cells_[column].span.offset + element * sizeof(T), sizeof(T));
+  return data;
+}
+
+std::string_view RowView::GetStringListElement(int column, int element) const {
+  Span span = GetListElement<Span>(column, element);
+  return std::string_view(arena_ + span.offset, span.size);
+}
+
+Row::Row(int size) { Reset(size); }
+
+Row::Row(const Row& other) : RowView(), cell_buf_(other.cell_buf_), arena_buf_(other.arena_buf_) { Attach(); }
+
+Row::Row(Row&& other) noexcept
+    : RowView(), cell_buf_(std::move(other.cell_buf_)), arena_buf_(std::move(other.arena_buf_)) {
+  Attach();
+  other.Attach();
+}
+
+Row& Row::operator=(const Row& other) {
+  if (this != &other) {
+    cell_buf_ = other.cell_buf_;
+    arena_buf_ = other.arena_buf_;
+    Attach();
+  }
+  return *this;
+}
+
+Row& Row::operator=(Row&& other) noexcept {
+  if (this != &other) {
+    cell_buf_ = std::move(other.cell_buf_);
+    arena_buf_ = std::move(other.arena_buf_);
+    Attach();
+    other.Attach();
+  }
+  return *this;
+}
+
+void Row::Attach() {
+  this->cells_ = cell_buf_.data();
+  this->size_ = cell_buf_.size();
+  this->arena_ = arena_buf_.data();
+}
+
+void Row::Reset(int size) {
+  Cell null_cell{};
+  null_cell.null = true;
+  cell_buf_.assign(size, null_cell);
+  arena_buf_.clear();
+  Attach();
+}
+
+void Row::SetNull(int column) { cell_buf_[column].null = true; }
+
+void Row::SetBool(int column, bool data) {
+  Cell& cell = cell_buf_[column];
+  cell.type = BaseSchema::kBool;
+  cell.null = false;
+  cell.b = data;
+}
+
+void Row::SetInt(int column, int32_t data) {
+  Cell& cell = cell_buf_[column];
+  cell.type = BaseSchema::kInteger;
+  cell.null = false;
+  cell.i = data;
+}
+
+void Row::SetFloat(int column, float data) {
+  Cell& cell = cell_buf_[column];
+  cell.type = BaseSchema::kFloat;
+  cell.null = false;
+  cell.f = data;
+}
+
+void Row::SetLong(int column, int64_t data) {
+  Cell& cell = cell_buf_[column];
+  cell.type = BaseSchema::kLong;
+  cell.null = false;
+  cell.l = data;
+}
+
+void Row::SetDouble(int column, double data) {
+  Cell& cell = cell_buf_[column];
+  cell.type = BaseSchema::kDouble;
+  cell.null = false;
+  cell.d = data;
+}
+
+template <typename T>
+void Row::SetScalar(int column, const std::optional<T>& data) {
+  if (!data.has_value()) {
+    SetNull(column);
+  } else if constexpr (std::is_same_v<T, bool>) {
+    SetBool(column, data.value());
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    SetInt(column, data.value());
+  } else if constexpr (std::is_same_v<T, float>) {
+    SetFloat(column, data.value());
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    SetLong(column, data.value());
+  } else {
+    SetDouble(column, data.value());
+  }
+}
+
+char* Row::Allocate(int column, BaseSchema::Type type, int count, int width) {
+  uint32_t offset = arena_buf_.size();
+  arena_buf_.resize(offset + count * width);
+  Attach();
+  Cell& cell = cell_buf_[column];
+  cell.type = type;
+  cell.null = false;
+  cell.span = {offset, static_cast<uint32_t>(count)};
+  return arena_buf_.data() + offset;
+}
+
+char* Row::AllocateString(int column, int size) { return Allocate(column, BaseSchema::kString, size, 1); }
+
+char* Row::AllocateList(int column, BaseSchema::Type type, int count) {
+  return Allocate(column, type, count, ListElementWidth(type));
+}
+
+char* Row::AllocateStringListElement(int column, int element, int size) {
+  Span span{static_cast<uint32_t>(arena_buf_.size()), static_cast<uint32_t>(size)};
+  arena_buf_.resize(span.offset + size);
+  Attach();
+  memcpy(arena_buf_.data() + cell_buf_[column].span.offset + element * sizeof(Span), &span, sizeof(Span));
+  return arena_buf_.data() + span.offset;
+}
+
+void Row::SetString(int column, std::string_view data) {
+  char* payload = AllocateString(column, data.size());
+  if (!data.empty()) {
+    memcpy(payload, data.data(), data.size());
+  }
+}
+
+template <typename T>
+void Row::SetList(int column, const std::vector<T>& data) {
+  char* payload = AllocateList(column, kListType<T>, data.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    T element = data[i];
+    memcpy(payload + i * sizeof(T), &element, sizeof(T));
+  }
+}
+
+void Row::SetStringList(int column, const std::vector<std::string>& data) {
+  AllocateList(column, BaseSchema::kStringList, data.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    char* payload = AllocateStringListElement(column, i, data[i].size());
+    if (!data[i].empty()) {
+      memcpy(payload, data[i].data(), data[i].size());
+    }
+  }
+}
+
+template <typename T>
+static void CopyList(Row& row, int column, const RowView& from, int from_column) {
+  int count = from.GetListSize(from_column);
+  char* payload = row.AllocateList(column, kListType<T>, count);
+  for (int i = 0; i < count; i++) {
+    T element = from.GetListElement<T>(from_column, i);
+    memcpy(payload + i * sizeof(T), &element, sizeof(T));
+  }
+}
+
+void Row::SetCell(int column, const RowView& from, int from_column) {
+  if (from.IsNull(from_column)) {
+    SetNull(column);
+    return;
+  }
+  switch (from.GetType(from_column)) {
+    case BaseSchema::kBool:
+      SetBool(column, from.GetBool(from_column));
+      break;
+    case BaseSchema::kInteger:
+      SetInt(column, from.GetInt(from_column));
+      break;
+    case BaseSchema::kFloat:
+      SetFloat(column, from.GetFloat(from_column));
+      break;
+    case BaseSchema::kLong:
+      SetLong(column, from.GetLong(from_column));
+      break;
+    case BaseSchema::kDouble:
+      SetDouble(column, from.GetDouble(from_column));
+      break;
+    case BaseSchema::kString:
+      SetString(column, from.GetString(from_column));
+      break;
+    case BaseSchema::kBoolList:
+      CopyList<bool>(*this, column, from, from_column);
+      break;
+    case BaseSchema::kIntegerList:
+      CopyList<int32_t>(*this, column, from, from_column);
+      break;
+    case BaseSchema::kFloatList:
+      CopyList<float>(*this, column, from, from_column);
+      break;
+    case BaseSchema::kLongList:
+      CopyList<int64_t>(*this, column, from, from_column);
+      break;
+    case BaseSchema::kDoubleList:
+      CopyList<double>(*this, column, from, from_column);
+      break;
+    case BaseSchema::kStringList: {
+      int count = from.GetListSize(from_column);
+      AllocateList(column, BaseSchema::kStringList, count);
+      for (int i = 0; i < count; i++) {
+        std::string_view element = from.GetStringListElement(from_column, i);
+        char* payload = AllocateStringListElement(column, i, element.size());
+        if (!element.empty()) {
+          memcpy(payload, element.data(), element.size());
+        }
+      }
+      break;
+    }
+  }
+}
+
+template std::optional<bool> RowView::GetScalar<bool>(int column) const;
+template std::optional<int32_t> RowView::GetScalar<int32_t>(int column) const;
+template std::optional<float> RowView::GetScalar<float>(int column) const;
+template std::optional<int64_t> RowView::GetScalar<int64_t>(int column) const;
+template std::optional<double> RowView::GetScalar<double>(int column) const;
+template bool RowView::GetListElement<bool>(int column, int element) const;
+template int32_t RowView::GetListElement<int32_t>(int column, int element) const;
+template float RowView::GetListElement<float>(int column, int element) const;
+template int64_t RowView::GetListElement<int64_t>(int column, int element) const;
+template double RowView::GetListElement<double>(int column, int element) const;
+template void Row::SetScalar<bool>(int column, const std::optional<bool>& data);
+template void Row::SetScalar<int32_t>(int column, const std::optional<int32_t>& data);
+template void Row::SetScalar<float>(int column, const std::optional<float>& data);
+template void Row::SetScalar<int64_t>(int column, const std::optional<int64_t>& data);
+template void Row::SetScalar<double>(int column, const std::optional<double>& data);
+template void Row::SetList<bool>(int column, const std::vector<bool>& data);
+template void Row::SetList<int32_t>(int column, const std::vector<int32_t>& data);
+template void Row::SetList<float>(int column, const std::vector<float>& data);
+template void Row::SetList<int64_t>(int column, const std::vector<int64_t>& data);
+template void Row::SetList<double>(int column, const std::vector<double>& data);
+
+}  // namespace dingodb
@@ -0,0 +1,133 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_ROW_H_
+#define DINGO_SERIAL_ROW_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {
+
+// Read-only, non-owning view of a typed record. Every column is a fixed size cell: scalars are stored inline,
+// strings and lists point into the arena of the row. The referenced Row must outlive the view and must not be
+// modified while the view is in use.
+class RowView {
+ public:
+  // Payload of a string or list cell, as an arena offset and a byte or element count.
+  struct Span {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  struct Cell {
+    BaseSchema::Type type;
+    bool null;
+    union {
+      bool b;
+      int32_t i;
+      float f;
+      int64_t l;
+      double d;
+      Span span;
+    };
+  };
+
+ protected:
+  const Cell* cells_ = nullptr;
+  int size_ = 0;
+  const char* arena_ = nullptr;
+
+ public:
+  RowView() = default;
+  RowView(const Cell* cells, int size, const char* arena);
+  ~RowView() = default;
+
+  int Size() const;
+  bool IsNull(int column) const;
+  BaseSchema::Type GetType(int column) const;
+
+  bool GetBool(int column) const;
+  int32_t GetInt(int column) const;
+  float GetFloat(int column) const;
+  int64_t GetLong(int column) const;
+  double GetDouble(int column) const;
+  // The scalar cell as the optional the schemas encode, nullopt for a null cell. T is bool, int32_t, float,
+  // int64_t or double.
+  template <typename T>
+  std::optional<T> GetScalar(int column) const;
+
+  std::string_view GetString(int column) const;
+
+  // Number of elements of a list cell.
+  int GetListSize(int column) const;
+  // Element of a bool, integer, float, long or double list, T is the element type.
+  template <typename T>
+  T GetListElement(int column, int element) const;
+  std::string_view GetStringListElement(int column, int element) const;
+};
+
+// Owning typed record. Payloads are appended to one arena per row, Reset keeps its capacity so a Row reused across
+// a scan stops allocating once it has seen its widest record.
+class Row : public RowView {
+ private:
+  std::vector<Cell> cell_buf_;
+  std::string arena_buf_;
+
+  void Attach();
+  char* Allocate(int column, BaseSchema::Type type, int count, int width);
+
+ public:
+  Row() = default;
+  explicit Row(int size);
+  Row(const Row& other);
+  Row(Row&& other) noexcept;
+  Row& operator=(const Row& other);
+  Row& operator=(Row&& other) noexcept;
+  ~Row() = default;
+
+  // size null cells and an empty arena.
+  void Reset(int size);
+
+  void SetNull(int column);
+  void SetBool(int column, bool data);
+  void SetInt(int column, int32_t data);
+  void SetFloat(int column, float data);
+  void SetLong(int column, int64_t data);
+  void SetDouble(int column, double data);
+  template <typename T>
+  void SetScalar(int column, const std::optional<T>& data);
+  void SetString(int column, std::string_view data);
+  // T is bool, int32_t, float, int64_t or double.
+  template <typename T>
+  void SetList(int column, const std::vector<T>& data);
+  void SetStringList(int column, const std::vector<std::string>& data);
+  // Copy of cell from_column of from, which must be another row.
+  void SetCell(int column, const RowView& from, int from_column);
+
+  // Reserve the payload of a cell and return where to write it, the pointer is valid until the next allocation.
+  // Decoders fill strings and lists in place this way. An allocated string list holds count empty elements.
+  char* AllocateString(int column, int size);
+  char* AllocateList(int column, BaseSchema::Type type, int count);
+  char* AllocateStringListElement(int column, int element, int size);
+};
+
+}  // namespace dingodb
+
+#endif
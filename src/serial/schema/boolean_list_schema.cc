@@ -43,6 +43,27 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::GetLength()
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::InternalEncodedValueLength(
+    bool is_null, size_t count) const {
+  int size = is_null ? 0 : 4 + count * GetDataLength();
+  return this->allow_null_ ? 1 + size : size;
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::GetEncodedValueLength(
+    const std::optional<std::shared_ptr<std::vector<bool>>>& data) const {
+  return InternalEncodedValueLength(!data.has_value(), data.has_value() ? data.value()->size() : 0);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::GetEncodedValueLength(const RowView& row,
+                                                                                          int column) const {
+  return InternalEncodedValueLength(row.IsNull(column), row.IsNull(column) ? 0 : row.GetListSize(column));
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::GetEncodedValueLength(const ColumnVector& column,
+                                                                                          int row) const {
+  return InternalEncodedValueLength(column.IsNull(row), column.IsNull(row) ? 0 : column.GetListSize(row));
+}
+
 void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::SetAllowNull(bool allow_null) {
   this->allow_null_ = allow_null;
 }
@@ -60,11 +81,11 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::EncodeKeyPr
 }
 
 std::optional<std::shared_ptr<std::vector<bool>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::DecodeKey(Buf* /*buf*/) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::DecodeKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::SkipKey(Buf* /*buf*/) {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::SkipKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
@@ -98,13 +119,16 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::EncodeValue
 }
 
 std::optional<std::shared_ptr<std::vector<bool>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::DecodeValue(Buf* buf) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return std::nullopt;
     }
   }
-  int length = buf->ReadInt();
+  int length = buf->ReadLength(1);
+  if (length < 0) {
+    return std::nullopt;
+  }
   std::shared_ptr<std::vector<bool>> vector = std::make_shared<std::vector<bool>>(length);
   for (int i = 0; i < length; i++) {
     bool b = buf->Read();
@@ -113,14 +137,73 @@ DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::DecodeValue(Buf*
   return vector;
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::SkipValue(Buf* buf) {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::SkipValue(BufView* buf) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      return;
+    }
+  }
+  int length = buf->ReadLength(1);
+  if (length >= 0) {
+    buf->Skip(length);
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                 int column) {
+  if (row.IsNull(column)) {
+    EncodeValue(buf, std::nullopt);
+    return;
+  }
+  int data_size = row.GetListSize(column);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue(buf, row.GetListElement<bool>(column, i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::EncodeValue(Buf* buf, const ColumnVector& column,
+                                                                                 int row) {
+  if (column.IsNull(row)) {
+    EncodeValue(buf, std::nullopt);
+    return;
+  }
+  int data_size = column.GetListSize(row);
+  int offset = column.GetListOffset(row);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue(buf, column.child->Get<bool>(offset + i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>>::DecodeValue(BufView* buf, Row* row, int column) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
+      row->SetNull(column);
       return;
     }
   }
-  int length = buf->ReadInt();
-  buf->Skip(length);
+  int length = buf->ReadLength(1);
+  if (length < 0) {
+    row->SetNull(column);
+    return;
+  }
+  char* data = row->AllocateList(column, kBoolList, length);
+  for (int i = 0; i < length; i++) {
+    data[i] = static_cast<bool>(buf->Read());
+  }
 }
 
 }  // namespace dingodb
\ No newline at end of file
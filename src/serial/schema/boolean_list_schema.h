@@ -33,6 +33,8 @@ class DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>> : public Ba
 
   static int GetDataLength();
   static int GetWithNullTagLength();
+  // Encoded size of a list of count elements, every GetEncodedValueLength overload goes through it.
+  int InternalEncodedValueLength(bool is_null, size_t count) const;
   static void InternalEncodeValue(Buf* buf, bool data);
   static void InternalEncodeNull(Buf* buf);
 
@@ -40,6 +42,10 @@ class DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>> : public Ba
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeValue.
+  int GetEncodedValueLength(const std::optional<std::shared_ptr<std::vector<bool>>>& data) const;
+  int GetEncodedValueLength(const RowView& row, int column) const;
+  int GetEncodedValueLength(const ColumnVector& column, int row) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -47,11 +53,18 @@ class DingoSchema<std::optional<std::shared_ptr<std::vector<bool>>>> : public Ba
   void SetAllowNull(bool allow_null);
   static void EncodeKey(Buf* buf, std::optional<std::shared_ptr<std::vector<bool>>> data);
   static void EncodeKeyPrefix(Buf* buf, std::optional<std::shared_ptr<std::vector<bool>>> data);
-  static std::optional<std::shared_ptr<std::vector<bool>>> DecodeKey(Buf* buf);
-  static void SkipKey(Buf* buf);
+  static std::optional<std::shared_ptr<std::vector<bool>>> DecodeKey(BufView* buf);
+  static void SkipKey(BufView* buf);
   void EncodeValue(Buf* buf, std::optional<std::shared_ptr<std::vector<bool>>> data);
-  std::optional<std::shared_ptr<std::vector<bool>>> DecodeValue(Buf* buf);
-  void SkipValue(Buf* buf);
+  std::optional<std::shared_ptr<std::vector<bool>>> DecodeValue(BufView* buf);
+  void SkipValue(BufView* buf);
+
+  // Typed row columns, the elements are read from and decoded into the row arena.
+  void EncodeValue(Buf* buf, const RowView& row, int column);
+  void DecodeValue(BufView* buf, Row* row, int column);
+
+  // Rows of a list column vector, the elements are read from its child.
+  void EncodeValue(Buf* buf, const ColumnVector& column, int row);
 };
 
 }  // namespace dingodb
@@ -41,6 +41,20 @@ int DingoSchema<std::optional<bool>>::GetLength() {
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<bool>>::GetEncodedKeyLength(const std::optional<bool>& data) const {
+  if (this->allow_null_) {
+    return data.has_value() ? GetWithNullTagLength() : 1;
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
+int DingoSchema<std::optional<bool>>::GetEncodedValueLength(const std::optional<bool>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
 void DingoSchema<std::optional<bool>>::SetAllowNull(bool allow_null) { this->allow_null_ = allow_null; }
 
 bool DingoSchema<std::optional<bool>>::AllowNull() { return this->allow_null_; }
@@ -66,7 +80,7 @@ void DingoSchema<std::optional<bool>>::EncodeKey(Buf* buf, std::optional<bool> d
 
 void DingoSchema<std::optional<bool>>::EncodeKeyPrefix(Buf* buf, std::optional<bool> data) { EncodeKey(buf, data); }
 
-std::optional<bool> DingoSchema<std::optional<bool>>::DecodeKey(Buf* buf) {
+std::optional<bool> DingoSchema<std::optional<bool>>::DecodeKey(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
@@ -77,7 +91,7 @@ std::optional<bool> DingoSchema<std::optional<bool>>::DecodeKey(Buf* buf) {
   return b;
 }
 
-void DingoSchema<std::optional<bool>>::SkipKey(Buf* buf) { buf->Skip(GetLength()); }
+void DingoSchema<std::optional<bool>>::SkipKey(BufView* buf) { buf->Skip(GetLength()); }
 
 void DingoSchema<std::optional<bool>>::EncodeValue(Buf* buf, std::optional<bool> data) {
   if (this->allow_null_) {
@@ -99,7 +113,7 @@ void DingoSchema<std::optional<bool>>::EncodeValue(Buf* buf, std::optional<bool>
   }
 }
 
-std::optional<bool> DingoSchema<std::optional<bool>>::DecodeValue(Buf* buf) {
+std::optional<bool> DingoSchema<std::optional<bool>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
@@ -110,6 +124,6 @@ std::optional<bool> DingoSchema<std::optional<bool>>::DecodeValue(Buf* buf) {
   return b;
 }
 
-void DingoSchema<std::optional<bool>>::SkipValue(Buf* buf) { buf->Skip(GetLength()); }
+void DingoSchema<std::optional<bool>>::SkipValue(BufView* buf) { buf->Skip(GetLength()); }
 
 }  // namespace dingodb
\ No newline at end of file
@@ -38,6 +38,9 @@ class DingoSchema<std::optional<bool>> : public BaseSchema {
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeKey and EncodeValue.
+  int GetEncodedKeyLength(const std::optional<bool>& data) const;
+  int GetEncodedValueLength(const std::optional<bool>& data) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -45,11 +48,11 @@ class DingoSchema<std::optional<bool>> : public BaseSchema {
   void SetAllowNull(bool allow_null);
   void EncodeKey(Buf* buf, std::optional<bool> data);
   void EncodeKeyPrefix(Buf* buf, std::optional<bool> data);
-  std::optional<bool> DecodeKey(Buf* buf);
-  void SkipKey(Buf* buf);
+  std::optional<bool> DecodeKey(BufView* buf);
+  void SkipKey(BufView* buf);
   void EncodeValue(Buf* buf, std::optional<bool> data);
-  std::optional<bool> DecodeValue(Buf* buf);
-  void SkipValue(Buf* buf);
+  std::optional<bool> DecodeValue(BufView* buf);
+  void SkipValue(BufView* buf);
 };
 
 }  // namespace dingodb
@@ -15,11 +15,29 @@
 #ifndef DINGO_SERIAL_DINGO_SCHEMA_H_
 #define DINGO_SERIAL_DINGO_SCHEMA_H_
 
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 #include "serial/buf.h"
+#include "serial/column_batch.h"
+#include "serial/row.h"
 #include "serial/schema/base_schema.h"
 
 namespace dingodb {
 
+// Schemas of these types follow the codec byte order and expose EncodeKey<LE>/DecodeKey<LE> and
+// EncodeValue<LE>/DecodeValue<LE>. Float schemas keep their own byte order and only have the runtime overloads.
+template <typename T>
+constexpr bool kFixedKeyByteOrder =
+    std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, double>;
+
+template <typename T>
+constexpr bool kFixedValueByteOrder =
+    kFixedKeyByteOrder<T> || std::is_same_v<T, std::shared_ptr<std::vector<int32_t>>> ||
+    std::is_same_v<T, std::shared_ptr<std::vector<int64_t>>> || std::is_same_v<T, std::shared_ptr<std::vector<double>>>;
+
 template <class T>
 class DingoSchema : public BaseSchema {
  public:
@@ -28,11 +46,11 @@ class DingoSchema : public BaseSchema {
   virtual void SetAllowNull(bool allow_null) = 0;
   virtual void EncodeKey(Buf* buf, T data) = 0;
   virtual void EncodeKeyPrefix(Buf* buf, T data) = 0;
-  virtual T DecodeKey(Buf* buf) = 0;
-  virtual void SkipKey(Buf* buf) = 0;
+  virtual T DecodeKey(BufView* buf) = 0;
+  virtual void SkipKey(BufView* buf) = 0;
   virtual void EncodeValue(Buf* buf, T data) = 0;
-  virtual T DecodeValue(Buf* buf) = 0;
-  virtual void SkipValue(Buf* buf) = 0;
+  virtual T DecodeValue(BufView* buf) = 0;
+  virtual void SkipValue(BufView* buf) = 0;
 };
 
 }  // namespace dingodb
@@ -22,30 +22,19 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetDataLen
 
 int DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetWithNullTagLength() { return 9; }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::LeInternalEncodeValue(Buf* buf, double data) {
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::InternalEncodeValue(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  buf->Write(bits >> 56);
-  buf->Write(bits >> 48);
-  buf->Write(bits >> 40);
-  buf->Write(bits >> 32);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 8);
-  buf->Write(bits);
+  buf->WriteLong<LE>(bits);
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::BeInternalEncodeValue(Buf* buf, double data) {
-  uint64_t bits;
-  memcpy(&bits, &data, 8);
-  buf->Write(bits);
-  buf->Write(bits >> 8);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 32);
-  buf->Write(bits >> 40);
-  buf->Write(bits >> 48);
-  buf->Write(bits >> 56);
+template <bool LE>
+double DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::InternalDecodeData(BufView* buf) {
+  uint64_t bits = buf->ReadLong<LE>();
+  double d;
+  memcpy(&d, &bits, 8);
+  return d;
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetType() { return kDoubleList; }
@@ -65,6 +54,27 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetLength(
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::InternalEncodedValueLength(
+    bool is_null, size_t count) const {
+  int size = is_null ? 0 : 4 + count * GetDataLength();
+  return this->allow_null_ ? 1 + size : size;
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetEncodedValueLength(
+    const std::optional<std::shared_ptr<std::vector<double>>>& data) const {
+  return InternalEncodedValueLength(!data.has_value(), data.has_value() ? data.value()->size() : 0);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetEncodedValueLength(const RowView& row,
+                                                                                            int column) const {
+  return InternalEncodedValueLength(row.IsNull(column), row.IsNull(column) ? 0 : row.GetListSize(column));
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetEncodedValueLength(const ColumnVector& column,
+                                                                                            int row) const {
+  return InternalEncodedValueLength(column.IsNull(row), column.IsNull(row) ? 0 : column.GetListSize(row));
+}
+
 void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::SetAllowNull(bool allow_null) {
   this->allow_null_ = allow_null;
 }
@@ -84,14 +94,15 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeKey
 }
 
 std::optional<std::shared_ptr<std::vector<double>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeKey(Buf* /*buf*/) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::SkipKey(Buf* /*buf*/) {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::SkipKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
+template <bool LE>
 void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue(
     Buf* buf, std::optional<std::shared_ptr<std::vector<double>>> data) {
   if (this->allow_null_) {
@@ -101,11 +112,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeVal
       buf->Write(k_not_null);
       buf->WriteInt(data_size);
       for (const double& value : *data.value()) {
-        if (this->le_) {
-          LeInternalEncodeValue(buf, value);
-        } else {
-          BeInternalEncodeValue(buf, value);
-        }
+        InternalEncodeValue<LE>(buf, value);
       }
     } else {
       buf->EnsureRemainder(1);
@@ -117,11 +124,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeVal
       buf->EnsureRemainder(4 + data_size * 8);
       buf->WriteInt(data_size);
       for (const double& value : *data.value()) {
-        if (this->le_) {
-          LeInternalEncodeValue(buf, value);
-        } else {
-          BeInternalEncodeValue(buf, value);
-        }
+        InternalEncodeValue<LE>(buf, value);
       }
     } else {
       // WRONG EMPTY DATA
@@ -129,48 +132,158 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeVal
   }
 }
 
-double DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::InternalDecodeData(Buf* buf) const {
-  uint64_t l = buf->Read() & 0xFF;
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<double>>> data) {
   if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
+    EncodeValue<true>(buf, data);
   } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
+    EncodeValue<false>(buf, data);
   }
-  // double d;
-  // memcpy(&d, &l, 8);
-  return *reinterpret_cast<double*>(&l);
-  // return d;
 }
 
+template <bool LE>
 std::optional<std::shared_ptr<std::vector<double>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue(Buf* buf) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return std::nullopt;
     }
   }
-  int length = buf->ReadInt();
+  int length = buf->ReadLength(8);
+  if (length < 0) {
+    return std::nullopt;
+  }
   std::shared_ptr<std::vector<double>> data = std::make_shared<std::vector<double>>();
   data->reserve(length);
   for (int i = 0; i < length; i++) {
-    data->emplace_back(InternalDecodeData(buf));
+    data->emplace_back(InternalDecodeData<LE>(buf));
   }
   return data;
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::SkipValue(Buf* buf) {
+std::optional<std::shared_ptr<std::vector<double>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue(BufView* buf) {
+  return this->le_ ? DecodeValue<true>(buf) : DecodeValue<false>(buf);
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::SkipValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return;
     }
   }
-  int length = buf->ReadInt();
-  buf->Skip(length * 8);
+  int length = buf->ReadLength(8);
+  if (length >= 0) {
+    buf->Skip(length * 8);
+  }
 }
 
-}  // namespace dingodb
\ No newline at end of file
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                   int column) {
+  if (row.IsNull(column)) {
+    EncodeValue<LE>(buf, std::nullopt);
+    return;
+  }
+  int data_size = row.GetListSize(column);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size * 8);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size * 8);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue<LE>(buf, row.GetListElement<double>(column, i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                   int column) {
+  if (this->le_) {
+    EncodeValue<true>(buf, row, column);
+  } else {
+    EncodeValue<false>(buf, row, column);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue(Buf* buf, const ColumnVector& column,
+                                                                                   int row) {
+  if (column.IsNull(row)) {
+    EncodeValue<LE>(buf, std::nullopt);
+    return;
+  }
+  int data_size = column.GetListSize(row);
+  int offset = column.GetListOffset(row);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size * 8);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size * 8);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue<LE>(buf, column.child->Get<double>(offset + i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue(Buf* buf, const ColumnVector& column,
+                                                                                   int row) {
+  if (this->le_) {
+    EncodeValue<true>(buf, column, row);
+  } else {
+    EncodeValue<false>(buf, column, row);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue(BufView* buf, Row* row, int column) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      row->SetNull(column);
+      return;
+    }
+  }
+  int length = buf->ReadLength(8);
+  if (length < 0) {
+    row->SetNull(column);
+    return;
+  }
+  char* data = row->AllocateList(column, kDoubleList, length);
+  for (int i = 0; i < length; i++) {
+    double value = InternalDecodeData<LE>(buf);
+    memcpy(data + i * 8, &value, 8);
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue(BufView* buf, Row* row, int column) {
+  if (this->le_) {
+    DecodeValue<true>(buf, row, column);
+  } else {
+    DecodeValue<false>(buf, row, column);
+  }
+}
+
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue<true>(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<double>>> data);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue<false>(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<double>>> data);
+template std::optional<std::shared_ptr<std::vector<double>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue<true>(BufView* buf);
+template std::optional<std::shared_ptr<std::vector<double>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue<false>(BufView* buf);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue<true>(
+    Buf* buf, const RowView& row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue<false>(
+    Buf* buf, const RowView& row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue<true>(
+    Buf* buf, const ColumnVector& column, int row);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeValue<false>(
+    Buf* buf, const ColumnVector& column, int row);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue<true>(
+    BufView* buf, Row* row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue<false>(
+    BufView* buf, Row* row, int column);
+
+}  // namespace dingodb
@@ -31,78 +31,22 @@ void DingoSchema<std::optional<double>>::InternalEncodeNull(Buf* buf) {
   buf->Write(0);
 }
 
-void DingoSchema<std::optional<double>>::LeInternalEncodeKey(Buf* buf, double data) {
+template <bool LE>
+void DingoSchema<std::optional<double>>::InternalEncodeKey(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
   if (data >= 0) {
-    buf->Write(bits >> 56 ^ 0x80);
-    buf->Write(bits >> 48);
-    buf->Write(bits >> 40);
-    buf->Write(bits >> 32);
-    buf->Write(bits >> 24);
-    buf->Write(bits >> 16);
-    buf->Write(bits >> 8);
-    buf->Write(bits);
+    buf->WriteLong<LE>(bits ^ kKeyFlip64<LE>);
   } else {
-    buf->Write(~bits >> 56);
-    buf->Write(~bits >> 48);
-    buf->Write(~bits >> 40);
-    buf->Write(~bits >> 32);
-    buf->Write(~bits >> 24);
-    buf->Write(~bits >> 16);
-    buf->Write(~bits >> 8);
-    buf->Write(~bits);
+    buf->WriteLong<LE>(~bits);
   }
 }
 
-void DingoSchema<std::optional<double>>::BeInternalEncodeKey(Buf* buf, double data) {
+template <bool LE>
+void DingoSchema<std::optional<double>>::InternalEncodeValue(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  if (data >= 0) {
-    buf->Write(bits ^ 0x80);
-    buf->Write(bits >> 8);
-    buf->Write(bits >> 16);
-    buf->Write(bits >> 24);
-    buf->Write(bits >> 32);
-    buf->Write(bits >> 40);
-    buf->Write(bits >> 48);
-    buf->Write(bits >> 56);
-  } else {
-    buf->Write(~bits);
-    buf->Write(~bits >> 8);
-    buf->Write(~bits >> 16);
-    buf->Write(~bits >> 24);
-    buf->Write(~bits >> 32);
-    buf->Write(~bits >> 40);
-    buf->Write(~bits >> 48);
-    buf->Write(~bits >> 56);
-  }
-}
-
-void DingoSchema<std::optional<double>>::LeInternalEncodeValue(Buf* buf, double data) {
-  uint64_t bits;
-  memcpy(&bits, &data, 8);
-  buf->Write(bits >> 56);
-  buf->Write(bits >> 48);
-  buf->Write(bits >> 40);
-  buf->Write(bits >> 32);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 8);
-  buf->Write(bits);
-}
-
-void DingoSchema<std::optional<double>>::BeInternalEncodeValue(Buf* buf, double data) {
-  uint64_t bits;
-  memcpy(&bits, &data, 8);
-  buf->Write(bits);
-  buf->Write(bits >> 8);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 32);
-  buf->Write(bits >> 40);
-  buf->Write(bits >> 48);
-  buf->Write(bits >> 56);
+  buf->WriteLong<LE>(bits);
 }
 
 BaseSchema::Type DingoSchema<std::optional<double>>::GetType() { return kDouble; }
@@ -122,22 +66,33 @@ int DingoSchema<std::optional<double>>::GetLength() {
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<double>>::GetEncodedKeyLength(const std::optional<double>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
+int DingoSchema<std::optional<double>>::GetEncodedValueLength(const std::optional<double>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
 void DingoSchema<std::optional<double>>::SetAllowNull(bool allow_null) { this->allow_null_ = allow_null; }
 
 bool DingoSchema<std::optional<double>>::AllowNull() { return allow_null_; }
 
 void DingoSchema<std::optional<double>>::SetIsLe(bool le) { this->le_ = le; }
 
+template <bool LE>
 void DingoSchema<std::optional<double>>::EncodeKey(Buf* buf, std::optional<double> data) {
   if (this->allow_null_) {
     buf->EnsureRemainder(GetWithNullTagLength());
     if (data.has_value()) {
       buf->Write(k_not_null);
-      if (this->le_) {
-        LeInternalEncodeKey(buf, data.value());
-      } else {
-        BeInternalEncodeKey(buf, data.value());
-      }
+      InternalEncodeKey<LE>(buf, data.value());
     } else {
       buf->Write(k_null);
       InternalEncodeNull(buf);
@@ -145,70 +100,60 @@ void DingoSchema<std::optional<double>>::EncodeKey(Buf* buf, std::optional<doubl
   } else {
     if (data.has_value()) {
       buf->EnsureRemainder(GetDataLength());
-      if (this->le_) {
-        LeInternalEncodeKey(buf, data.value());
-      } else {
-        BeInternalEncodeKey(buf, data.value());
-      }
+      InternalEncodeKey<LE>(buf, data.value());
     } else {
       // WRONG EMPTY DATA
     }
   }
 }
 
+void DingoSchema<std::optional<double>>::EncodeKey(Buf* buf, std::optional<double> data) {
+  if (this->le_) {
+    EncodeKey<true>(buf, data);
+  } else {
+    EncodeKey<false>(buf, data);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<double>>::EncodeKeyPrefix(Buf* buf, std::optional<double> data) {
+  EncodeKey<LE>(buf, data);
+}
+
 void DingoSchema<std::optional<double>>::EncodeKeyPrefix(Buf* buf, std::optional<double> data) { EncodeKey(buf, data); }
-std::optional<double> DingoSchema<std::optional<double>>::DecodeKey(Buf* buf) {
+
+template <bool LE>
+std::optional<double> DingoSchema<std::optional<double>>::DecodeKey(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
       return std::nullopt;
     }
   }
-  uint64_t l = buf->Read() & 0xFF;
-  if (this->le_) {
-    if (l >= 0x80) {
-      l = l ^ 0x80;
-      for (int i = 0; i < 7; i++) {
-        l <<= 8;
-        l |= buf->Read() & 0xFF;
-      }
-    } else {
-      l = ~l;
-      for (int i = 0; i < 7; i++) {
-        l <<= 8;
-        l |= ~buf->Read() & 0xFF;
-      }
-    }
+  uint64_t bits = buf->ReadLong<LE>();
+  if (bits & kKeyFlip64<LE>) {
+    bits ^= kKeyFlip64<LE>;
   } else {
-    if (l >= 0x80) {
-      l = l ^ 0x80;
-      for (int i = 1; i < 8; i++) {
-        l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-      }
-    } else {
-      for (int i = 1; i < 8; i++) {
-        l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-      }
-      l = ~l;
-    }
+    bits = ~bits;
   }
   double d;
-  memcpy(&d, &l, 8);
+  memcpy(&d, &bits, 8);
   return d;
 }
 
-void DingoSchema<std::optional<double>>::SkipKey(Buf* buf) { buf->Skip(GetLength()); }
+std::optional<double> DingoSchema<std::optional<double>>::DecodeKey(BufView* buf) {
+  return this->le_ ? DecodeKey<true>(buf) : DecodeKey<false>(buf);
+}
+
+void DingoSchema<std::optional<double>>::SkipKey(BufView* buf) { buf->Skip(GetLength()); }
 
+template <bool LE>
 void DingoSchema<std::optional<double>>::EncodeValue(Buf* buf, std::optional<double> data) {
   if (this->allow_null_) {
     buf->EnsureRemainder(GetWithNullTagLength());
     if (data.has_value()) {
       buf->Write(k_not_null);
-      if (this->le_) {
-        LeInternalEncodeValue(buf, data.value());
-      } else {
-        BeInternalEncodeValue(buf, data.value());
-      }
+      InternalEncodeValue<LE>(buf, data.value());
     } else {
       buf->Write(k_null);
       InternalEncodeNull(buf);
@@ -216,41 +161,50 @@ void DingoSchema<std::optional<double>>::EncodeValue(Buf* buf, std::optional<dou
   } else {
     if (data.has_value()) {
       buf->EnsureRemainder(GetDataLength());
-      if (this->le_) {
-        LeInternalEncodeValue(buf, data.value());
-      } else {
-        BeInternalEncodeValue(buf, data.value());
-      }
+      InternalEncodeValue<LE>(buf, data.value());
     } else {
       // WRONG EMPTY DATA
     }
   }
 }
 
-std::optional<double> DingoSchema<std::optional<double>>::DecodeValue(Buf* buf) {
+void DingoSchema<std::optional<double>>::EncodeValue(Buf* buf, std::optional<double> data) {
+  if (this->le_) {
+    EncodeValue<true>(buf, data);
+  } else {
+    EncodeValue<false>(buf, data);
+  }
+}
+
+template <bool LE>
+std::optional<double> DingoSchema<std::optional<double>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
       return std::nullopt;
     }
   }
-  uint64_t l = buf->Read() & 0xFF;
-  ;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
+  uint64_t bits = buf->ReadLong<LE>();
   double d;
-  memcpy(&d, &l, 8);
+  memcpy(&d, &bits, 8);
   return d;
 }
 
-void DingoSchema<std::optional<double>>::SkipValue(Buf* buf) { buf->Skip(GetLength()); }
+std::optional<double> DingoSchema<std::optional<double>>::DecodeValue(BufView* buf) {
+  return this->le_ ? DecodeValue<true>(buf) : DecodeValue<false>(buf);
+}
+
+void DingoSchema<std::optional<double>>::SkipValue(BufView* buf) { buf->Skip(GetLength()); }
+
+template void DingoSchema<std::optional<double>>::EncodeKey<true>(Buf* buf, std::optional<double> data);
+template void DingoSchema<std::optional<double>>::EncodeKey<false>(Buf* buf, std::optional<double> data);
+template void DingoSchema<std::optional<double>>::EncodeKeyPrefix<true>(Buf* buf, std::optional<double> data);
+template void DingoSchema<std::optional<double>>::EncodeKeyPrefix<false>(Buf* buf, std::optional<double> data);
+template std::optional<double> DingoSchema<std::optional<double>>::DecodeKey<true>(BufView* buf);
+template std::optional<double> DingoSchema<std::optional<double>>::DecodeKey<false>(BufView* buf);
+template void DingoSchema<std::optional<double>>::EncodeValue<true>(Buf* buf, std::optional<double> data);
+template void DingoSchema<std::optional<double>>::EncodeValue<false>(Buf* buf, std::optional<double> data);
+template std::optional<double> DingoSchema<std::optional<double>>::DecodeValue<true>(BufView* buf);
+template std::optional<double> DingoSchema<std::optional<double>>::DecodeValue<false>(BufView* buf);
 
-}  // namespace dingodb
\ No newline at end of file
+}  // namespace dingodb
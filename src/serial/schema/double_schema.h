@@ -34,15 +34,18 @@ class DingoSchema<std::optional<double>> : public BaseSchema {
   static int GetDataLength();
   static int GetWithNullTagLength();
   static void InternalEncodeNull(Buf* buf);
-  static void LeInternalEncodeKey(Buf* buf, double data);
-  static void BeInternalEncodeKey(Buf* buf, double data);
-  static void LeInternalEncodeValue(Buf* buf, double data);
-  static void BeInternalEncodeValue(Buf* buf, double data);
+  template <bool LE>
+  static void InternalEncodeKey(Buf* buf, double data);
+  template <bool LE>
+  static void InternalEncodeValue(Buf* buf, double data);
 
  public:
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeKey and EncodeValue.
+  int GetEncodedKeyLength(const std::optional<double>& data) const;
+  int GetEncodedValueLength(const std::optional<double>& data) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -51,11 +54,23 @@ class DingoSchema<std::optional<double>> : public BaseSchema {
   void SetIsLe(bool le);
   void EncodeKey(Buf* buf, std::optional<double> data);
   void EncodeKeyPrefix(Buf* buf, std::optional<double> data);
-  std::optional<double> DecodeKey(Buf* buf);
-  void SkipKey(Buf* buf);
+  std::optional<double> DecodeKey(BufView* buf);
+  void SkipKey(BufView* buf);
   void EncodeValue(Buf* buf, std::optional<double> data);
-  std::optional<double> DecodeValue(Buf* buf);
-  void SkipValue(Buf* buf);
+  std::optional<double> DecodeValue(BufView* buf);
+  void SkipValue(BufView* buf);
+
+  // Byte order fixed at compile time, the overloads above dispatch on SetIsLe.
+  template <bool LE>
+  void EncodeKey(Buf* buf, std::optional<double> data);
+  template <bool LE>
+  void EncodeKeyPrefix(Buf* buf, std::optional<double> data);
+  template <bool LE>
+  std::optional<double> DecodeKey(BufView* buf);
+  template <bool LE>
+  void EncodeValue(Buf* buf, std::optional<double> data);
+  template <bool LE>
+  std::optional<double> DecodeValue(BufView* buf);
 };
 
 }  // namespace dingodb
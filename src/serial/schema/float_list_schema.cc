@@ -14,28 +14,27 @@
 
 #include "serial/schema/float_list_schema.h"
 
+#include <cstring>
+
 namespace dingodb {
 
 int DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetDataLength() { return 4; }
 
 int DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetWithNullTagLength() { return 5; }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::LeInternalEncodeValue(Buf* buf, float data) {
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::InternalEncodeValue(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 8);
-  buf->Write(bits);
+  buf->WriteInt<LE>(bits);
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::BeInternalEncodeValue(Buf* buf, float data) {
-  uint32_t bits;
-  memcpy(&bits, &data, 4);
-  buf->Write(bits);
-  buf->Write(bits >> 8);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 24);
+template <bool LE>
+float DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::InternalDecodeData(BufView* buf) {
+  uint32_t bits = buf->ReadInt<LE>();
+  float d;
+  memcpy(&d, &bits, 4);
+  return d;
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetType() { return kFloatList; }
@@ -55,6 +54,27 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetLength()
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::InternalEncodedValueLength(
+    bool is_null, size_t count) const {
+  int size = is_null ? 0 : 4 + count * GetDataLength();
+  return this->allow_null_ ? 1 + size : size;
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetEncodedValueLength(
+    const std::optional<std::shared_ptr<std::vector<float>>>& data) const {
+  return InternalEncodedValueLength(!data.has_value(), data.has_value() ? data.value()->size() : 0);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetEncodedValueLength(const RowView& row,
+                                                                                           int column) const {
+  return InternalEncodedValueLength(row.IsNull(column), row.IsNull(column) ? 0 : row.GetListSize(column));
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetEncodedValueLength(const ColumnVector& column,
+                                                                                           int row) const {
+  return InternalEncodedValueLength(column.IsNull(row), column.IsNull(row) ? 0 : column.GetListSize(row));
+}
+
 void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::SetAllowNull(bool allow_null) {
   this->allow_null_ = allow_null;
 }
@@ -73,14 +93,15 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeKeyP
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 std::optional<std::shared_ptr<std::vector<float>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeKey(Buf* /*buf*/) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::SkipKey(Buf* /*buf*/) {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::SkipKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
+template <bool LE>
 void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue(
     Buf* buf, std::optional<std::shared_ptr<std::vector<float>>> data) {
   if (this->allow_null_) {
@@ -90,11 +111,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValu
       buf->Write(k_not_null);
       buf->WriteInt(data_size);
       for (const float& value : *data.value()) {
-        if (this->le_) {
-          LeInternalEncodeValue(buf, value);
-        } else {
-          BeInternalEncodeValue(buf, value);
-        }
+        InternalEncodeValue<LE>(buf, value);
       }
     } else {
       buf->EnsureRemainder(1);
@@ -106,11 +123,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValu
       buf->EnsureRemainder(4 + data_size * 4);
       buf->WriteInt(data_size);
       for (const float& value : *data.value()) {
-        if (this->le_) {
-          LeInternalEncodeValue(buf, value);
-        } else {
-          BeInternalEncodeValue(buf, value);
-        }
+        InternalEncodeValue<LE>(buf, value);
       }
     } else {
       // WRONG EMPTY DATA
@@ -118,48 +131,158 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValu
   }
 }
 
-float DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::InternalDecodeData(Buf* buf) const {
-  uint32_t in = buf->Read() & 0xFF;
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<float>>> data) {
   if (this->le_) {
-    for (int i = 0; i < 3; i++) {
-      in <<= 8;
-      in |= buf->Read() & 0xFF;
-    }
+    EncodeValue<true>(buf, data);
   } else {
-    for (int i = 1; i < 4; i++) {
-      in |= (((uint32_t)buf->Read() & 0xFF) << (8 * i));
-    }
+    EncodeValue<false>(buf, data);
   }
-  //   float d;
-  //   memcpy(&d, &in, 4);
-  //   return d;
-  return *reinterpret_cast<float*>(&in);
 }
 
+template <bool LE>
 std::optional<std::shared_ptr<std::vector<float>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue(Buf* buf) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return std::nullopt;
     }
   }
-  int length = buf->ReadInt();
+  int length = buf->ReadLength(4);
+  if (length < 0) {
+    return std::nullopt;
+  }
   std::shared_ptr<std::vector<float>> data = std::make_shared<std::vector<float>>();
   data->reserve(length);
   for (int i = 0; i < length; i++) {
-    data->emplace_back(InternalDecodeData(buf));
+    data->emplace_back(InternalDecodeData<LE>(buf));
   }
   return data;
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::SkipValue(Buf* buf) {
+std::optional<std::shared_ptr<std::vector<float>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue(BufView* buf) {
+  return this->le_ ? DecodeValue<true>(buf) : DecodeValue<false>(buf);
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::SkipValue(BufView* buf) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      return;
+    }
+  }
+  int length = buf->ReadLength(4);
+  if (length >= 0) {
+    buf->Skip(length * 4);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                  int column) {
+  if (row.IsNull(column)) {
+    EncodeValue<LE>(buf, std::nullopt);
+    return;
+  }
+  int data_size = row.GetListSize(column);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size * 4);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size * 4);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue<LE>(buf, row.GetListElement<float>(column, i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                  int column) {
+  if (this->le_) {
+    EncodeValue<true>(buf, row, column);
+  } else {
+    EncodeValue<false>(buf, row, column);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue(Buf* buf, const ColumnVector& column,
+                                                                                  int row) {
+  if (column.IsNull(row)) {
+    EncodeValue<LE>(buf, std::nullopt);
+    return;
+  }
+  int data_size = column.GetListSize(row);
+  int offset = column.GetListOffset(row);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size * 4);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size * 4);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue<LE>(buf, column.child->Get<float>(offset + i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue(Buf* buf, const ColumnVector& column,
+                                                                                  int row) {
+  if (this->le_) {
+    EncodeValue<true>(buf, column, row);
+  } else {
+    EncodeValue<false>(buf, column, row);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue(BufView* buf, Row* row, int column) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
+      row->SetNull(column);
       return;
     }
   }
-  int length = buf->ReadInt();
-  buf->Skip(length * 4);
+  int length = buf->ReadLength(4);
+  if (length < 0) {
+    row->SetNull(column);
+    return;
+  }
+  char* data = row->AllocateList(column, kFloatList, length);
+  for (int i = 0; i < length; i++) {
+    float value = InternalDecodeData<LE>(buf);
+    memcpy(data + i * 4, &value, 4);
+  }
 }
 
-}  // namespace dingodb
\ No newline at end of file
+void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue(BufView* buf, Row* row, int column) {
+  if (this->le_) {
+    DecodeValue<true>(buf, row, column);
+  } else {
+    DecodeValue<false>(buf, row, column);
+  }
+}
+
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue<true>(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<float>>> data);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue<false>(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<float>>> data);
+template std::optional<std::shared_ptr<std::vector<float>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue<true>(BufView* buf);
+template std::optional<std::shared_ptr<std::vector<float>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue<false>(BufView* buf);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue<true>(
+    Buf* buf, const RowView& row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue<false>(
+    Buf* buf, const RowView& row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue<true>(
+    Buf* buf, const ColumnVector& column, int row);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValue<false>(
+    Buf* buf, const ColumnVector& column, int row);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue<true>(
+    BufView* buf, Row* row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue<false>(
+    BufView* buf, Row* row, int column);
+
+}  // namespace dingodb
@@ -27,54 +27,22 @@ void DingoSchema<std::optional<float>>::InternalEncodeNull(Buf* buf) {
   buf->Write(0);
 }
 
-void DingoSchema<std::optional<float>>::LeInternalEncodeKey(Buf* buf, float data) {
+template <bool LE>
+void DingoSchema<std::optional<float>>::InternalEncodeKey(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
   if (data >= 0) {
-    buf->Write(bits >> 24 ^ 0x80);
-    buf->Write(bits >> 16);
-    buf->Write(bits >> 8);
-    buf->Write(bits);
+    buf->WriteInt<LE>(bits ^ kKeyFlip32<LE>);
   } else {
-    buf->Write(~bits >> 24);
-    buf->Write(~bits >> 16);
-    buf->Write(~bits >> 8);
-    buf->Write(~bits);
+    buf->WriteInt<LE>(~bits);
   }
 }
 
-void DingoSchema<std::optional<float>>::BeInternalEncodeKey(Buf* buf, float data) {
+template <bool LE>
+void DingoSchema<std::optional<float>>::InternalEncodeValue(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  if (data >= 0) {
-    buf->Write(bits ^ 0x80);
-    buf->Write(bits >> 8);
-    buf->Write(bits >> 16);
-    buf->Write(bits >> 24);
-  } else {
-    buf->Write(~bits);
-    buf->Write(~bits >> 8);
-    buf->Write(~bits >> 16);
-    buf->Write(~bits >> 24);
-  }
-}
-
-void DingoSchema<std::optional<float>>::LeInternalEncodeValue(Buf* buf, float data) {
-  uint32_t bits;
-  memcpy(&bits, &data, 4);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 8);
-  buf->Write(bits);
-}
-
-void DingoSchema<std::optional<float>>::BeInternalEncodeValue(Buf* buf, float data) {
-  uint32_t bits;
-  memcpy(&bits, &data, 4);
-  buf->Write(bits);
-  buf->Write(bits >> 8);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 24);
+  buf->WriteInt<LE>(bits);
 }
 
 BaseSchema::Type DingoSchema<std::optional<float>>::GetType() { return kFloat; }
@@ -94,22 +62,33 @@ int DingoSchema<std::optional<float>>::GetLength() {
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<float>>::GetEncodedKeyLength(const std::optional<float>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
+int DingoSchema<std::optional<float>>::GetEncodedValueLength(const std::optional<float>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
 void DingoSchema<std::optional<float>>::SetAllowNull(bool allow_null) { this->allow_null_ = allow_null; }
 
 bool DingoSchema<std::optional<float>>::AllowNull() { return allow_null_; }
 
 void DingoSchema<std::optional<float>>::SetIsLe(bool le) { this->le_ = le; }
 
+template <bool LE>
 void DingoSchema<std::optional<float>>::EncodeKey(Buf* buf, std::optional<float> data) {
   if (this->allow_null_) {
     buf->EnsureRemainder(GetWithNullTagLength());
     if (data.has_value()) {
       buf->Write(k_not_null);
-      if (this->le_) {
-        LeInternalEncodeKey(buf, data.value());
-      } else {
-        BeInternalEncodeKey(buf, data.value());
-      }
+      InternalEncodeKey<LE>(buf, data.value());
     } else {
       buf->Write(k_null);
       InternalEncodeNull(buf);
@@ -117,70 +96,60 @@ void DingoSchema<std::optional<float>>::EncodeKey(Buf* buf, std::optional<float>
   } else {
     if (data.has_value()) {
       buf->EnsureRemainder(GetDataLength());
-      if (this->le_) {
-        LeInternalEncodeKey(buf, data.value());
-      } else {
-        BeInternalEncodeKey(buf, data.value());
-      }
+      InternalEncodeKey<LE>(buf, data.value());
     } else {
       // WRONG EMPTY DATA
     }
   }
 }
 
+void DingoSchema<std::optional<float>>::EncodeKey(Buf* buf, std::optional<float> data) {
+  if (this->le_) {
+    EncodeKey<true>(buf, data);
+  } else {
+    EncodeKey<false>(buf, data);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<float>>::EncodeKeyPrefix(Buf* buf, std::optional<float> data) {
+  EncodeKey<LE>(buf, data);
+}
+
 void DingoSchema<std::optional<float>>::EncodeKeyPrefix(Buf* buf, std::optional<float> data) { EncodeKey(buf, data); }
-std::optional<float> DingoSchema<std::optional<float>>::DecodeKey(Buf* buf) {
+
+template <bool LE>
+std::optional<float> DingoSchema<std::optional<float>>::DecodeKey(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
       return std::nullopt;
     }
   }
-  uint32_t in = buf->Read() & 0xFF;
-  if (this->le_) {
-    if (in >= 0x80) {
-      in = in ^ 0x80;
-      for (int i = 0; i < 3; i++) {
-        in <<= 8;
-        in |= buf->Read() & 0xFF;
-      }
-    } else {
-      in = ~in;
-      for (int i = 0; i < 3; i++) {
-        in <<= 8;
-        in |= ~buf->Read() & 0xFF;
-      }
-    }
+  uint32_t bits = buf->ReadInt<LE>();
+  if (bits & kKeyFlip32<LE>) {
+    bits ^= kKeyFlip32<LE>;
   } else {
-    if (in >= 0x80) {
-      in = in ^ 0x80;
-      for (int i = 1; i < 4; i++) {
-        in |= (((uint32_t)buf->Read() & 0xFF) << (8 * i));
-      }
-    } else {
-      for (int i = 1; i < 4; i++) {
-        in |= (((uint32_t)buf->Read() & 0xFF) << (8 * i));
-      }
-      in = ~in;
-    }
+    bits = ~bits;
   }
   float d;
-  memcpy(&d, &in, 4);
+  memcpy(&d, &bits, 4);
   return d;
 }
 
-void DingoSchema<std::optional<float>>::SkipKey(Buf* buf) { buf->Skip(GetLength()); }
+std::optional<float> DingoSchema<std::optional<float>>::DecodeKey(BufView* buf) {
+  return this->le_ ? DecodeKey<true>(buf) : DecodeKey<false>(buf);
+}
+
+void DingoSchema<std::optional<float>>::SkipKey(BufView* buf) { buf->Skip(GetLength()); }
 
+template <bool LE>
 void DingoSchema<std::optional<float>>::EncodeValue(Buf* buf, std::optional<float> data) {
   if (this->allow_null_) {
     buf->EnsureRemainder(GetWithNullTagLength());
     if (data.has_value()) {
       buf->Write(k_not_null);
-      if (this->le_) {
-        LeInternalEncodeValue(buf, data.value());
-      } else {
-        BeInternalEncodeValue(buf, data.value());
-      }
+      InternalEncodeValue<LE>(buf, data.value());
     } else {
       buf->Write(k_null);
       InternalEncodeNull(buf);
@@ -188,41 +157,50 @@ void DingoSchema<std::optional<float>>::EncodeValue(Buf* buf, std::optional<floa
   } else {
     if (data.has_value()) {
       buf->EnsureRemainder(GetDataLength());
-      if (this->le_) {
-        LeInternalEncodeValue(buf, data.value());
-      } else {
-        BeInternalEncodeValue(buf, data.value());
-      }
+      InternalEncodeValue<LE>(buf, data.value());
     } else {
       // WRONG EMPTY DATA
     }
   }
 }
 
-std::optional<float> DingoSchema<std::optional<float>>::DecodeValue(Buf* buf) {
+void DingoSchema<std::optional<float>>::EncodeValue(Buf* buf, std::optional<float> data) {
+  if (this->le_) {
+    EncodeValue<true>(buf, data);
+  } else {
+    EncodeValue<false>(buf, data);
+  }
+}
+
+template <bool LE>
+std::optional<float> DingoSchema<std::optional<float>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
       return std::nullopt;
     }
   }
-  uint32_t in = buf->Read() & 0xFF;
-  ;
-  if (this->le_) {
-    for (int i = 0; i < 3; i++) {
-      in <<= 8;
-      in |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 4; i++) {
-      in |= (((uint32_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
+  uint32_t bits = buf->ReadInt<LE>();
   float d;
-  memcpy(&d, &in, 4);
+  memcpy(&d, &bits, 4);
   return d;
 }
 
-void DingoSchema<std::optional<float>>::SkipValue(Buf* buf) { buf->Skip(GetLength()); }
+std::optional<float> DingoSchema<std::optional<float>>::DecodeValue(BufView* buf) {
+  return this->le_ ? DecodeValue<true>(buf) : DecodeValue<false>(buf);
+}
+
+void DingoSchema<std::optional<float>>::SkipValue(BufView* buf) { buf->Skip(GetLength()); }
+
+template void DingoSchema<std::optional<float>>::EncodeKey<true>(Buf* buf, std::optional<float> data);
+template void DingoSchema<std::optional<float>>::EncodeKey<false>(Buf* buf, std::optional<float> data);
+template void DingoSchema<std::optional<float>>::EncodeKeyPrefix<true>(Buf* buf, std::optional<float> data);
+template void DingoSchema<std::optional<float>>::EncodeKeyPrefix<false>(Buf* buf, std::optional<float> data);
+template std::optional<float> DingoSchema<std::optional<float>>::DecodeKey<true>(BufView* buf);
+template std::optional<float> DingoSchema<std::optional<float>>::DecodeKey<false>(BufView* buf);
+template void DingoSchema<std::optional<float>>::EncodeValue<true>(Buf* buf, std::optional<float> data);
+template void DingoSchema<std::optional<float>>::EncodeValue<false>(Buf* buf, std::optional<float> data);
+template std::optional<float> DingoSchema<std::optional<float>>::DecodeValue<true>(BufView* buf);
+template std::optional<float> DingoSchema<std::optional<float>>::DecodeValue<false>(BufView* buf);
 
-}  // namespace dingodb
\ No newline at end of file
+}  // namespace dingodb
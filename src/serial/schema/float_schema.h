@@ -34,15 +34,18 @@ class DingoSchema<std::optional<float>> : public BaseSchema {
   static int GetDataLength();
   static int GetWithNullTagLength();
   static void InternalEncodeNull(Buf* buf);
-  static void LeInternalEncodeKey(Buf* buf, float data);
-  static void BeInternalEncodeKey(Buf* buf, float data);
-  static void LeInternalEncodeValue(Buf* buf, float data);
-  static void BeInternalEncodeValue(Buf* buf, float data);
+  template <bool LE>
+  static void InternalEncodeKey(Buf* buf, float data);
+  template <bool LE>
+  static void InternalEncodeValue(Buf* buf, float data);
 
  public:
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeKey and EncodeValue.
+  int GetEncodedKeyLength(const std::optional<float>& data) const;
+  int GetEncodedValueLength(const std::optional<float>& data) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -51,11 +54,23 @@ class DingoSchema<std::optional<float>> : public BaseSchema {
   void SetIsLe(bool le);
   void EncodeKey(Buf* buf, std::optional<float> data);
   void EncodeKeyPrefix(Buf* buf, std::optional<float> data);
-  std::optional<float> DecodeKey(Buf* buf);
-  void SkipKey(Buf* buf);
+  std::optional<float> DecodeKey(BufView* buf);
+  void SkipKey(BufView* buf);
   void EncodeValue(Buf* buf, std::optional<float> data);
-  std::optional<float> DecodeValue(Buf* buf);
-  void SkipValue(Buf* buf);
+  std::optional<float> DecodeValue(BufView* buf);
+  void SkipValue(BufView* buf);
+
+  // Byte order fixed at compile time, the overloads above dispatch on SetIsLe.
+  template <bool LE>
+  void EncodeKey(Buf* buf, std::optional<float> data);
+  template <bool LE>
+  void EncodeKeyPrefix(Buf* buf, std::optional<float> data);
+  template <bool LE>
+  std::optional<float> DecodeKey(BufView* buf);
+  template <bool LE>
+  void EncodeValue(Buf* buf, std::optional<float> data);
+  template <bool LE>
+  std::optional<float> DecodeValue(BufView* buf);
 };
 
 }  // namespace dingodb
@@ -14,26 +14,22 @@
 
 #include "serial/schema/integer_list_schema.h"
 
+#include <cstring>
+
 namespace dingodb {
 
 int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetDataLength() { return 4; }
 
 int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetWithNullTagLength() { return 5; }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::LeInternalEncodeValue(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i >> 24);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 8);
-  buf->Write(*i);
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::InternalEncodeValue(Buf* buf, int32_t data) {
+  buf->WriteInt<LE>(data);
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::BeInternalEncodeValue(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i);
-  buf->Write(*i >> 8);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 24);
+template <bool LE>
+uint32_t DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::InternalDecodeData(BufView* buf) {
+  return buf->ReadInt<LE>();
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetType() { return kIntegerList; }
@@ -53,6 +49,27 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetLength
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::InternalEncodedValueLength(
+    bool is_null, size_t count) const {
+  int size = is_null ? 0 : 4 + count * GetDataLength();
+  return this->allow_null_ ? 1 + size : size;
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetEncodedValueLength(
+    const std::optional<std::shared_ptr<std::vector<int32_t>>>& data) const {
+  return InternalEncodedValueLength(!data.has_value(), data.has_value() ? data.value()->size() : 0);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetEncodedValueLength(const RowView& row,
+                                                                                             int column) const {
+  return InternalEncodedValueLength(row.IsNull(column), row.IsNull(column) ? 0 : row.GetListSize(column));
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetEncodedValueLength(const ColumnVector& column,
+                                                                                             int row) const {
+  return InternalEncodedValueLength(column.IsNull(row), column.IsNull(row) ? 0 : column.GetListSize(row));
+}
+
 void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::SetAllowNull(bool allow_null) {
   this->allow_null_ = allow_null;
 }
@@ -72,14 +89,15 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeKe
 }
 
 std::optional<std::shared_ptr<std::vector<int32_t>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeKey(Buf* /*buf*/) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::SkipKey(Buf* /*buf*/) {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::SkipKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
+template <bool LE>
 void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue(
     Buf* buf, std::optional<std::shared_ptr<std::vector<int32_t>>> data) {
   if (this->allow_null_) {
@@ -89,11 +107,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeVa
       buf->Write(k_not_null);
       buf->WriteInt(data_size);
       for (const int32_t& value : *data.value()) {
-        if (this->le_) {
-          LeInternalEncodeValue(buf, value);
-        } else {
-          BeInternalEncodeValue(buf, value);
-        }
+        InternalEncodeValue<LE>(buf, value);
       }
     } else {
       buf->EnsureRemainder(1);
@@ -105,11 +119,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeVa
       buf->EnsureRemainder(4 + data_size * 4);
       buf->WriteInt(data_size);
       for (const int32_t& value : *data.value()) {
-        if (this->le_) {
-          LeInternalEncodeValue(buf, value);
-        } else {
-          BeInternalEncodeValue(buf, value);
-        }
+        InternalEncodeValue<LE>(buf, value);
       }
     } else {
       // WRONG EMPTY DATA
@@ -117,41 +127,160 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeVa
   }
 }
 
-uint32_t DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::InternalDecodeData(Buf* buf) const {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<int32_t>>> data) {
   if (this->le_) {
-    uint32_t r = ((buf->Read() & 0xFF) << 24) | ((buf->Read() & 0xFF) << 16) | ((buf->Read() & 0xFF) << 8) |
-                 (buf->Read() & 0xFF);
-    return r;
+    EncodeValue<true>(buf, data);
   } else {
-    uint32_t r = (buf->Read() & 0xFF) | ((buf->Read() & 0xFF) << 8) | ((buf->Read() & 0xFF) << 16) |
-                 ((buf->Read() & 0xFF) << 24);
-    return r;
+    EncodeValue<false>(buf, data);
   }
 }
 
+template <bool LE>
 std::optional<std::shared_ptr<std::vector<int32_t>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue(Buf* buf) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return std::nullopt;
     }
   }
-  int length = buf->ReadInt();
+  int length = buf->ReadLength(4);
+  if (length < 0) {
+    return std::nullopt;
+  }
   std::shared_ptr<std::vector<int32_t>> data = std::make_shared<std::vector<int32_t>>();
   data->reserve(length);
   for (int i = 0; i < length; i++) {
-    data->emplace_back(InternalDecodeData(buf));
+    data->emplace_back(InternalDecodeData<LE>(buf));
   }
   return data;
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::SkipValue(Buf* buf) {
+std::optional<std::shared_ptr<std::vector<int32_t>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue(BufView* buf) {
+  return this->le_ ? DecodeValue<true>(buf) : DecodeValue<false>(buf);
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::SkipValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return;
     }
   }
-  int length = buf->ReadInt();
-  buf->Skip(length * 4);
+  int length = buf->ReadLength(4);
+  if (length >= 0) {
+    buf->Skip(length * 4);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                    int column) {
+  if (row.IsNull(column)) {
+    EncodeValue<LE>(buf, std::nullopt);
+    return;
+  }
+  int data_size = row.GetListSize(column);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size * 4);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size * 4);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue<LE>(buf, row.GetListElement<int32_t>(column, i));
+  }
 }
-}  // namespace dingodb
\ No newline at end of file
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                    int column) {
+  if (this->le_) {
+    EncodeValue<true>(buf, row, column);
+  } else {
+    EncodeValue<false>(buf, row, column);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue(
+    Buf* buf, const ColumnVector& column, int row) {
+  if (column.IsNull(row)) {
+    EncodeValue<LE>(buf, std::nullopt);
+    return;
+  }
+  int data_size = column.GetListSize(row);
+  int offset = column.GetListOffset(row);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size * 4);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size * 4);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue<LE>(buf, column.child->Get<int32_t>(offset + i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue(
+    Buf* buf, const ColumnVector& column, int row) {
+  if (this->le_) {
+    EncodeValue<true>(buf, column, row);
+  } else {
+    EncodeValue<false>(buf, column, row);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue(BufView* buf, Row* row,
+                                                                                    int column) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      row->SetNull(column);
+      return;
+    }
+  }
+  int length = buf->ReadLength(4);
+  if (length < 0) {
+    row->SetNull(column);
+    return;
+  }
+  char* data = row->AllocateList(column, kIntegerList, length);
+  for (int i = 0; i < length; i++) {
+    int32_t value = InternalDecodeData<LE>(buf);
+    memcpy(data + i * 4, &value, 4);
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue(BufView* buf, Row* row,
+                                                                                    int column) {
+  if (this->le_) {
+    DecodeValue<true>(buf, row, column);
+  } else {
+    DecodeValue<false>(buf, row, column);
+  }
+}
+
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue<true>(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<int32_t>>> data);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue<false>(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<int32_t>>> data);
+template std::optional<std::shared_ptr<std::vector<int32_t>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue<true>(BufView* buf);
+template std::optional<std::shared_ptr<std::vector<int32_t>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue<false>(BufView* buf);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue<true>(
+    Buf* buf, const RowView& row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue<false>(
+    Buf* buf, const RowView& row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue<true>(
+    Buf* buf, const ColumnVector& column, int row);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeValue<false>(
+    Buf* buf, const ColumnVector& column, int row);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue<true>(
+    BufView* buf, Row* row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue<false>(
+    BufView* buf, Row* row, int column);
+
+}  // namespace dingodb
@@ -34,13 +34,21 @@ class DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>> : public
 
   static int GetDataLength();
   static int GetWithNullTagLength();
-  static void LeInternalEncodeValue(Buf* buf, int32_t data);
-  static void BeInternalEncodeValue(Buf* buf, int32_t data);
+  // Encoded size of a list of count elements, every GetEncodedValueLength overload goes through it.
+  int InternalEncodedValueLength(bool is_null, size_t count) const;
+  template <bool LE>
+  static void InternalEncodeValue(Buf* buf, int32_t data);
+  template <bool LE>
+  static uint32_t InternalDecodeData(BufView* buf);
 
  public:
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeValue.
+  int GetEncodedValueLength(const std::optional<std::shared_ptr<std::vector<int32_t>>>& data) const;
+  int GetEncodedValueLength(const RowView& row, int column) const;
+  int GetEncodedValueLength(const ColumnVector& column, int row) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -49,12 +57,30 @@ class DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>> : public
   void SetIsLe(bool le);
   static void EncodeKey(Buf* buf, std::optional<std::shared_ptr<std::vector<int32_t>>> data);
   static void EncodeKeyPrefix(Buf* buf, std::optional<std::shared_ptr<std::vector<int32_t>>> data);
-  static std::optional<std::shared_ptr<std::vector<int32_t>>> DecodeKey(Buf* buf);
-  static void SkipKey(Buf* buf);
-  uint32_t InternalDecodeData(Buf* buf) const;
+  static std::optional<std::shared_ptr<std::vector<int32_t>>> DecodeKey(BufView* buf);
+  static void SkipKey(BufView* buf);
   void EncodeValue(Buf* buf, std::optional<std::shared_ptr<std::vector<int32_t>>> data);
-  std::optional<std::shared_ptr<std::vector<int32_t>>> DecodeValue(Buf* buf);
-  void SkipValue(Buf* buf);
+  std::optional<std::shared_ptr<std::vector<int32_t>>> DecodeValue(BufView* buf);
+  void SkipValue(BufView* buf);
+
+  // Byte order of the elements fixed at compile time, the list length follows the buffer.
+  template <bool LE>
+  void EncodeValue(Buf* buf, std::optional<std::shared_ptr<std::vector<int32_t>>> data);
+  template <bool LE>
+  std::optional<std::shared_ptr<std::vector<int32_t>>> DecodeValue(BufView* buf);
+
+  // Typed row columns, the elements are read from and decoded into the row arena.
+  void EncodeValue(Buf* buf, const RowView& row, int column);
+  void DecodeValue(BufView* buf, Row* row, int column);
+  template <bool LE>
+  void EncodeValue(Buf* buf, const RowView& row, int column);
+  template <bool LE>
+  void DecodeValue(BufView* buf, Row* row, int column);
+
+  // Rows of a list column vector, the elements are read from its child.
+  void EncodeValue(Buf* buf, const ColumnVector& column, int row);
+  template <bool LE>
+  void EncodeValue(Buf* buf, const ColumnVector& column, int row);
 };
 
 }  // namespace dingodb
@@ -27,36 +27,14 @@ void DingoSchema<std::optional<int32_t>>::InternalEncodeNull(Buf* buf) {
   buf->Write(0);
 }
 
-void DingoSchema<std::optional<int32_t>>::LeInternalEncodeKey(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i >> 24 ^ 0x80);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 8);
-  buf->Write(*i);
+template <bool LE>
+void DingoSchema<std::optional<int32_t>>::InternalEncodeKey(Buf* buf, int32_t data) {
+  buf->WriteInt<LE>(data ^ kKeyFlip32<LE>);
 }
 
-void DingoSchema<std::optional<int32_t>>::BeInternalEncodeKey(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i ^ 0x80);
-  buf->Write(*i >> 8);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 24);
-}
-
-void DingoSchema<std::optional<int32_t>>::LeInternalEncodeValue(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i >> 24);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 8);
-  buf->Write(*i);
-}
-
-void DingoSchema<std::optional<int32_t>>::BeInternalEncodeValue(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i);
-  buf->Write(*i >> 8);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 24);
+template <bool LE>
+void DingoSchema<std::optional<int32_t>>::InternalEncodeValue(Buf* buf, int32_t data) {
+  buf->WriteInt<LE>(data);
 }
 
 BaseSchema::Type DingoSchema<std::optional<int32_t>>::GetType() { return kInteger; }
@@ -76,22 +54,33 @@ int DingoSchema<std::optional<int32_t>>::GetLength() {
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<int32_t>>::GetEncodedKeyLength(const std::optional<int32_t>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
+int DingoSchema<std::optional<int32_t>>::GetEncodedValueLength(const std::optional<int32_t>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
 void DingoSchema<std::optional<int32_t>>::SetAllowNull(bool allow_null) { this->allow_null_ = allow_null; }
 
 bool DingoSchema<std::optional<int32_t>>::AllowNull() { return this->allow_null_; }
 
 void DingoSchema<std::optional<int32_t>>::SetIsLe(bool le) { this->le_ = le; }
 
+template <bool LE>
 void DingoSchema<std::optional<int32_t>>::EncodeKey(Buf* buf, std::optional<int32_t> data) {
   if (this->allow_null_) {
     buf->EnsureRemainder(GetWithNullTagLength());
     if (data.has_value()) {
       buf->Write(k_not_null);
-      if (this->le_) {
-        LeInternalEncodeKey(buf, data.value());
-      } else {
-        BeInternalEncodeKey(buf, data.value());
-      }
+      InternalEncodeKey<LE>(buf, data.value());
     } else {
       buf->Write(k_null);
       InternalEncodeNull(buf);
@@ -99,51 +88,54 @@ void DingoSchema<std::optional<int32_t>>::EncodeKey(Buf* buf, std::optional<int3
   } else {
     if (data.has_value()) {
       buf->EnsureRemainder(GetDataLength());
-      if (this->le_) {
-        LeInternalEncodeKey(buf, data.value());
-      } else {
-        BeInternalEncodeKey(buf, data.value());
-      }
+      InternalEncodeKey<LE>(buf, data.value());
     } else {
       // WRONG EMPTY DATA
     }
   }
 }
 
+void DingoSchema<std::optional<int32_t>>::EncodeKey(Buf* buf, std::optional<int32_t> data) {
+  if (this->le_) {
+    EncodeKey<true>(buf, data);
+  } else {
+    EncodeKey<false>(buf, data);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<int32_t>>::EncodeKeyPrefix(Buf* buf, std::optional<int32_t> data) {
+  EncodeKey<LE>(buf, data);
+}
+
 void DingoSchema<std::optional<int32_t>>::EncodeKeyPrefix(Buf* buf, std::optional<int32_t> data) {
   EncodeKey(buf, data);
 }
 
-std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeKey(Buf* buf) {
+template <bool LE>
+std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeKey(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
       return std::nullopt;
     }
   }
-  if (this->le_) {
-    uint32_t r = (((buf->Read() & 0xFF) ^ 0x80) << 24) | ((buf->Read() & 0xFF) << 16) | ((buf->Read() & 0xFF) << 8) |
-                 (buf->Read() & 0xFF);
-    return r;
-  } else {
-    uint32_t r = ((buf->Read() & 0xFF) ^ 0x80) | ((buf->Read() & 0xFF) << 8) | ((buf->Read() & 0xFF) << 16) |
-                 ((buf->Read() & 0xFF) << 24);
-    return r;
-  }
+  return static_cast<int32_t>(buf->ReadInt<LE>() ^ kKeyFlip32<LE>);
+}
+
+std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeKey(BufView* buf) {
+  return this->le_ ? DecodeKey<true>(buf) : DecodeKey<false>(buf);
 }
 
-void DingoSchema<std::optional<int32_t>>::SkipKey(Buf* buf) { buf->Skip(GetLength()); }
+void DingoSchema<std::optional<int32_t>>::SkipKey(BufView* buf) { buf->Skip(GetLength()); }
 
+template <bool LE>
 void DingoSchema<std::optional<int32_t>>::EncodeValue(Buf* buf, std::optional<int32_t> data) {
   if (this->allow_null_) {
     buf->EnsureRemainder(GetWithNullTagLength());
     if (data.has_value()) {
       buf->Write(k_not_null);
-      if (this->le_) {
-        LeInternalEncodeValue(buf, data.value());
-      } else {
-        BeInternalEncodeValue(buf, data.value());
-      }
+      InternalEncodeValue<LE>(buf, data.value());
     } else {
       buf->Write(k_null);
       InternalEncodeNull(buf);
@@ -151,35 +143,47 @@ void DingoSchema<std::optional<int32_t>>::EncodeValue(Buf* buf, std::optional<in
   } else {
     if (data.has_value()) {
       buf->EnsureRemainder(GetDataLength());
-      if (this->le_) {
-        LeInternalEncodeValue(buf, data.value());
-      } else {
-        BeInternalEncodeValue(buf, data.value());
-      }
+      InternalEncodeValue<LE>(buf, data.value());
     } else {
       // WRONG EMPTY DATA
     }
   }
 }
 
-std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeValue(Buf* buf) {
+void DingoSchema<std::optional<int32_t>>::EncodeValue(Buf* buf, std::optional<int32_t> data) {
+  if (this->le_) {
+    EncodeValue<true>(buf, data);
+  } else {
+    EncodeValue<false>(buf, data);
+  }
+}
+
+template <bool LE>
+std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
       return std::nullopt;
     }
   }
-  if (this->le_) {
-    uint32_t r = ((buf->Read() & 0xFF) << 24) | ((buf->Read() & 0xFF) << 16) | ((buf->Read() & 0xFF) << 8) |
-                 (buf->Read() & 0xFF);
-    return r;
-  } else {
-    uint32_t r = (buf->Read() & 0xFF) | ((buf->Read() & 0xFF) << 8) | ((buf->Read() & 0xFF) << 16) |
-                 ((buf->Read() & 0xFF) << 24);
-    return r;
-  }
+  return buf->ReadInt<LE>();
 }
 
-void DingoSchema<std::optional<int32_t>>::SkipValue(Buf* buf) { buf->Skip(GetLength()); }
+std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeValue(BufView* buf) {
+  return this->le_ ? DecodeValue<true>(buf) : DecodeValue<false>(buf);
+}
+
+void DingoSchema<std::optional<int32_t>>::SkipValue(BufView* buf) { buf->Skip(GetLength()); }
+
+template void DingoSchema<std::optional<int32_t>>::EncodeKey<true>(Buf* buf, std::optional<int32_t> data);
+template void DingoSchema<std::optional<int32_t>>::EncodeKey<false>(Buf* buf, std::optional<int32_t> data);
+template void DingoSchema<std::optional<int32_t>>::EncodeKeyPrefix<true>(Buf* buf, std::optional<int32_t> data);
+template void DingoSchema<std::optional<int32_t>>::EncodeKeyPrefix<false>(Buf* buf, std::optional<int32_t> data);
+template std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeKey<true>(BufView* buf);
+template std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeKey<false>(BufView* buf);
+template void DingoSchema<std::optional<int32_t>>::EncodeValue<true>(Buf* buf, std::optional<int32_t> data);
+template void DingoSchema<std::optional<int32_t>>::EncodeValue<false>(Buf* buf, std::optional<int32_t> data);
+template std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeValue<true>(BufView* buf);
+template std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeValue<false>(BufView* buf);
 
-}  // namespace dingodb
\ No newline at end of file
+}  // namespace dingodb
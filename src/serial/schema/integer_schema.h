@@ -33,15 +33,18 @@ class DingoSchema<std::optional<int32_t>> : public BaseSchema {
   static int GetDataLength();
   static int GetWithNullTagLength();
   static void InternalEncodeNull(Buf* buf);
-  static void LeInternalEncodeKey(Buf* buf, int32_t data);
-  static void BeInternalEncodeKey(Buf* buf, int32_t data);
-  static void LeInternalEncodeValue(Buf* buf, int32_t data);
-  static void BeInternalEncodeValue(Buf* buf, int32_t data);
+  template <bool LE>
+  static void InternalEncodeKey(Buf* buf, int32_t data);
+  template <bool LE>
+  static void InternalEncodeValue(Buf* buf, int32_t data);
 
  public:
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeKey and EncodeValue.
+  int GetEncodedKeyLength(const std::optional<int32_t>& data) const;
+  int GetEncodedValueLength(const std::optional<int32_t>& data) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -50,11 +53,23 @@ class DingoSchema<std::optional<int32_t>> : public BaseSchema {
   void SetIsLe(bool le);
   void EncodeKey(Buf* buf, std::optional<int32_t> data);
   void EncodeKeyPrefix(Buf* buf, std::optional<int32_t> data);
-  std::optional<int32_t> DecodeKey(Buf* buf);
-  void SkipKey(Buf* buf);
+  std::optional<int32_t> DecodeKey(BufView* buf);
+  void SkipKey(BufView* buf);
   void EncodeValue(Buf* buf, std::optional<int32_t> data);
-  std::optional<int32_t> DecodeValue(Buf* buf);
-  void SkipValue(Buf* buf);
+  std::optional<int32_t> DecodeValue(BufView* buf);
+  void SkipValue(BufView* buf);
+
+  // Byte order fixed at compile time, the overloads above dispatch on SetIsLe.
+  template <bool LE>
+  void EncodeKey(Buf* buf, std::optional<int32_t> data);
+  template <bool LE>
+  void EncodeKeyPrefix(Buf* buf, std::optional<int32_t> data);
+  template <bool LE>
+  std::optional<int32_t> DecodeKey(BufView* buf);
+  template <bool LE>
+  void EncodeValue(Buf* buf, std::optional<int32_t> data);
+  template <bool LE>
+  std::optional<int32_t> DecodeValue(BufView* buf);
 };
 
 }  // namespace dingodb
@@ -14,34 +14,22 @@
 
 #include "serial/schema/long_list_schema.h"
 
+#include <cstring>
+
 namespace dingodb {
 
 int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetDataLength() { return 8; }
 
 int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetWithNullTagLength() { return 9; }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::LeInternalEncodeValue(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l >> 56);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 8);
-  buf->Write(*l);
-}
-
-void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::BeInternalEncodeValue(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l);
-  buf->Write(*l >> 8);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 56);
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::InternalEncodeValue(Buf* buf, int64_t data) {
+  buf->WriteLong<LE>(data);
+}
+
+template <bool LE>
+uint64_t DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::InternalDecodeData(BufView* buf) {
+  return buf->ReadLong<LE>();
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetType() { return kLongList; }
@@ -61,6 +49,27 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetLength
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::InternalEncodedValueLength(
+    bool is_null, size_t count) const {
+  int size = is_null ? 0 : 4 + count * GetDataLength();
+  return this->allow_null_ ? 1 + size : size;
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetEncodedValueLength(
+    const std::optional<std::shared_ptr<std::vector<int64_t>>>& data) const {
+  return InternalEncodedValueLength(!data.has_value(), data.has_value() ? data.value()->size() : 0);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetEncodedValueLength(const RowView& row,
+                                                                                             int column) const {
+  return InternalEncodedValueLength(row.IsNull(column), row.IsNull(column) ? 0 : row.GetListSize(column));
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetEncodedValueLength(const ColumnVector& column,
+                                                                                             int row) const {
+  return InternalEncodedValueLength(column.IsNull(row), column.IsNull(row) ? 0 : column.GetListSize(row));
+}
+
 void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::SetAllowNull(bool allow_null) {
   this->allow_null_ = allow_null;
 }
@@ -80,14 +89,15 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeKe
 }
 
 std::optional<std::shared_ptr<std::vector<int64_t>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeKey(Buf* /*buf*/) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::SkipKey(Buf* /*buf*/) {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::SkipKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
+template <bool LE>
 void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue(
     Buf* buf, std::optional<std::shared_ptr<std::vector<int64_t>>> data) {
   if (this->allow_null_) {
@@ -97,11 +107,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeVa
       buf->Write(k_not_null);
       buf->WriteInt(data_size);
       for (const int64_t& value : *data.value()) {
-        if (this->le_) {
-          LeInternalEncodeValue(buf, value);
-        } else {
-          BeInternalEncodeValue(buf, value);
-        }
+        InternalEncodeValue<LE>(buf, value);
       }
     } else {
       buf->EnsureRemainder(1);
@@ -113,11 +119,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeVa
       buf->EnsureRemainder(4 + data_size * 8);
       buf->WriteInt(data_size);
       for (const int64_t& value : *data.value()) {
-        if (this->le_) {
-          LeInternalEncodeValue(buf, value);
-        } else {
-          BeInternalEncodeValue(buf, value);
-        }
+        InternalEncodeValue<LE>(buf, value);
       }
     } else {
       // WRONG EMPTY DATA
@@ -125,44 +127,160 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeVa
   }
 }
 
-uint64_t DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::InternalDecodeData(Buf* buf) const {
-  uint64_t l = buf->Read() & 0xFF;
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<int64_t>>> data) {
   if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
+    EncodeValue<true>(buf, data);
   } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
+    EncodeValue<false>(buf, data);
   }
-  return l;
 }
 
+template <bool LE>
 std::optional<std::shared_ptr<std::vector<int64_t>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue(Buf* buf) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return std::nullopt;
     }
   }
-  int length = buf->ReadInt();
+  int length = buf->ReadLength(8);
+  if (length < 0) {
+    return std::nullopt;
+  }
   std::shared_ptr<std::vector<int64_t>> data = std::make_shared<std::vector<int64_t>>();
   data->reserve(length);
   for (int i = 0; i < length; i++) {
-    data->emplace_back(InternalDecodeData(buf));
+    data->emplace_back(InternalDecodeData<LE>(buf));
   }
   return data;
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::SkipValue(Buf* buf) {
+std::optional<std::shared_ptr<std::vector<int64_t>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue(BufView* buf) {
+  return this->le_ ? DecodeValue<true>(buf) : DecodeValue<false>(buf);
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::SkipValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return;
     }
   }
-  int length = buf->ReadInt();
-  buf->Skip(length * 8);
+  int length = buf->ReadLength(8);
+  if (length >= 0) {
+    buf->Skip(length * 8);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                    int column) {
+  if (row.IsNull(column)) {
+    EncodeValue<LE>(buf, std::nullopt);
+    return;
+  }
+  int data_size = row.GetListSize(column);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size * 8);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size * 8);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue<LE>(buf, row.GetListElement<int64_t>(column, i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                    int column) {
+  if (this->le_) {
+    EncodeValue<true>(buf, row, column);
+  } else {
+    EncodeValue<false>(buf, row, column);
+  }
 }
-}  // namespace dingodb
\ No newline at end of file
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue(
+    Buf* buf, const ColumnVector& column, int row) {
+  if (column.IsNull(row)) {
+    EncodeValue<LE>(buf, std::nullopt);
+    return;
+  }
+  int data_size = column.GetListSize(row);
+  int offset = column.GetListOffset(row);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5 + data_size * 8);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4 + data_size * 8);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEncodeValue<LE>(buf, column.child->Get<int64_t>(offset + i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue(
+    Buf* buf, const ColumnVector& column, int row) {
+  if (this->le_) {
+    EncodeValue<true>(buf, column, row);
+  } else {
+    EncodeValue<false>(buf, column, row);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue(BufView* buf, Row* row,
+                                                                                    int column) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      row->SetNull(column);
+      return;
+    }
+  }
+  int length = buf->ReadLength(8);
+  if (length < 0) {
+    row->SetNull(column);
+    return;
+  }
+  char* data = row->AllocateList(column, kLongList, length);
+  for (int i = 0; i < length; i++) {
+    int64_t value = InternalDecodeData<LE>(buf);
+    memcpy(data + i * 8, &value, 8);
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue(BufView* buf, Row* row,
+                                                                                    int column) {
+  if (this->le_) {
+    DecodeValue<true>(buf, row, column);
+  } else {
+    DecodeValue<false>(buf, row, column);
+  }
+}
+
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue<true>(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<int64_t>>> data);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue<false>(
+    Buf* buf, std::optional<std::shared_ptr<std::vector<int64_t>>> data);
+template std::optional<std::shared_ptr<std::vector<int64_t>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue<true>(BufView* buf);
+template std::optional<std::shared_ptr<std::vector<int64_t>>>
+DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue<false>(BufView* buf);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue<true>(
+    Buf* buf, const RowView& row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue<false>(
+    Buf* buf, const RowView& row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue<true>(
+    Buf* buf, const ColumnVector& column, int row);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::EncodeValue<false>(
+    Buf* buf, const ColumnVector& column, int row);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue<true>(
+    BufView* buf, Row* row, int column);
+template void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue<false>(
+    BufView* buf, Row* row, int column);
+
+}  // namespace dingodb
@@ -31,60 +31,22 @@ void DingoSchema<std::optional<int64_t>>::InternalEncodeNull(Buf* buf) {
   buf->Write(0);
 }
 
+template <bool LE>
+void DingoSchema<std::optional<int64_t>>::InternalEncodeKey(Buf* buf, int64_t data) {
+  buf->WriteLong<LE>(data ^ kKeyFlip64<LE>);
+}
+
 void DingoSchema<std::optional<int64_t>>::InternalEncodeKey(Buf* buf, int64_t data) {
   if (buf->IsLe()) {
-    LeInternalEncodeKey(buf, data);
+    InternalEncodeKey<true>(buf, data);
   } else {
-    BeInternalEncodeKey(buf, data);
+    InternalEncodeKey<false>(buf, data);
   }
 }
 
-void DingoSchema<std::optional<int64_t>>::LeInternalEncodeKey(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l >> 56 ^ 0x80);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 8);
-  buf->Write(*l);
-}
-
-void DingoSchema<std::optional<int64_t>>::BeInternalEncodeKey(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l ^ 0x80);
-  buf->Write(*l >> 8);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 56);
-}
-
-void DingoSchema<std::optional<int64_t>>::LeInternalEncodeValue(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l >> 56);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 8);
-  buf->Write(*l);
-}
-
-void DingoSchema<std::optional<int64_t>>::BeInternalEncodeValue(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l);
-  buf->Write(*l >> 8);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 56);
+template <bool LE>
+void DingoSchema<std::optional<int64_t>>::InternalEncodeValue(Buf* buf, int64_t data) {
+  buf->WriteLong<LE>(data);
 }
 
 BaseSchema::Type DingoSchema<std::optional<int64_t>>::GetType() { return kLong; }
@@ -104,22 +66,33 @@ int DingoSchema<std::optional<int64_t>>::GetLength() {
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<int64_t>>::GetEncodedKeyLength(const std::optional<int64_t>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
+int DingoSchema<std::optional<int64_t>>::GetEncodedValueLength(const std::optional<int64_t>& data) const {
+  if (this->allow_null_) {
+    return GetWithNullTagLength();
+  }
+  return data.has_value() ? GetDataLength() : 0;
+}
+
 void DingoSchema<std::optional<int64_t>>::SetAllowNull(bool allow_null) { this->allow_null_ = allow_null; }
 
 bool DingoSchema<std::optional<int64_t>>::AllowNull() { return this->allow_null_; }
 
 void DingoSchema<std::optional<int64_t>>::SetIsLe(bool le) { this->le_ = le; }
 
+template <bool LE>
 void DingoSchema<std::optional<int64_t>>::EncodeKey(Buf* buf, std::optional<int64_t> data) {
   if (this->allow_null_) {
     buf->EnsureRemainder(GetWithNullTagLength());
     if (data.has_value()) {
       buf->Write(k_not_null);
-      if (this->le_) {
-        LeInternalEncodeKey(buf, data.value());
-      } else {
-        BeInternalEncodeKey(buf, data.value());
-      }
+      InternalEncodeKey<LE>(buf, data.value());
     } else {
       buf->Write(k_null);
       InternalEncodeNull(buf);
@@ -127,70 +100,61 @@ void DingoSchema<std::optional<int64_t>>::EncodeKey(Buf* buf, std::optional<int6
   } else {
     if (data.has_value()) {
       buf->EnsureRemainder(GetDataLength());
-      if (this->le_) {
-        LeInternalEncodeKey(buf, data.value());
-      } else {
-        BeInternalEncodeKey(buf, data.value());
-      }
+      InternalEncodeKey<LE>(buf, data.value());
     } else {
       // WRONG EMPTY DATA
     }
   }
 }
 
+void DingoSchema<std::optional<int64_t>>::EncodeKey(Buf* buf, std::optional<int64_t> data) {
+  if (this->le_) {
+    EncodeKey<true>(buf, data);
+  } else {
+    EncodeKey<false>(buf, data);
+  }
+}
+
+template <bool LE>
+void DingoSchema<std::optional<int64_t>>::EncodeKeyPrefix(Buf* buf, std::optional<int64_t> data) {
+  EncodeKey<LE>(buf, data);
+}
+
 void DingoSchema<std::optional<int64_t>>::EncodeKeyPrefix(Buf* buf, std::optional<int64_t> data) {
   EncodeKey(buf, data);
 }
 
-int64_t DingoSchema<std::optional<int64_t>>::InternalDecodeKey(Buf* buf) {
-  uint64_t l = (buf->Read() & 0xFF) ^ 0x80;
+int64_t DingoSchema<std::optional<int64_t>>::InternalDecodeKey(BufView* buf) {
   if (buf->IsLe()) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
+    return buf->ReadLong<true>() ^ kKeyFlip64<true>;
   }
-
-  return l;
+  return buf->ReadLong<false>() ^ kKeyFlip64<false>;
 }
 
-std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeKey(Buf* buf) {
+template <bool LE>
+std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeKey(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
       return std::nullopt;
     }
   }
-  uint64_t l = (buf->Read() & 0xFF) ^ 0x80;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
-  return l;
+  return static_cast<int64_t>(buf->ReadLong<LE>() ^ kKeyFlip64<LE>);
+}
+
+std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeKey(BufView* buf) {
+  return this->le_ ? DecodeKey<true>(buf) : DecodeKey<false>(buf);
 }
 
-void DingoSchema<std::optional<int64_t>>::SkipKey(Buf* buf) { buf->Skip(GetLength()); }
+void DingoSchema<std::optional<int64_t>>::SkipKey(BufView* buf) { buf->Skip(GetLength()); }
 
+template <bool LE>
 void DingoSchema<std::optional<int64_t>>::EncodeValue(Buf* buf, std::optional<int64_t> data) {
   if (this->allow_null_) {
     buf->EnsureRemainder(GetWithNullTagLength());
     if (data.has_value()) {
       buf->Write(k_not_null);
-      if (this->le_) {
-        LeInternalEncodeValue(buf, data.value());
-      } else {
-        BeInternalEncodeValue(buf, data.value());
-      }
+      InternalEncodeValue<LE>(buf, data.value());
     } else {
       buf->Write(k_null);
       InternalEncodeNull(buf);
@@ -198,38 +162,47 @@ void DingoSchema<std::optional<int64_t>>::EncodeValue(Buf* buf, std::optional<in
   } else {
     if (data.has_value()) {
       buf->EnsureRemainder(GetDataLength());
-      if (this->le_) {
-        LeInternalEncodeValue(buf, data.value());
-      } else {
-        BeInternalEncodeValue(buf, data.value());
-      }
+      InternalEncodeValue<LE>(buf, data.value());
     } else {
       // WRONG EMPTY DATA
     }
   }
 }
 
-std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeValue(Buf* buf) {
+void DingoSchema<std::optional<int64_t>>::EncodeValue(Buf* buf, std::optional<int64_t> data) {
+  if (this->le_) {
+    EncodeValue<true>(buf, data);
+  } else {
+    EncodeValue<false>(buf, data);
+  }
+}
+
+template <bool LE>
+std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->Skip(GetDataLength());
       return std::nullopt;
     }
   }
-  uint64_t l = buf->Read() & 0xFF;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
-  return l;
+  return buf->ReadLong<LE>();
 }
 
-void DingoSchema<std::optional<int64_t>>::SkipValue(Buf* buf) { buf->Skip(GetLength()); }
+std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeValue(BufView* buf) {
+  return this->le_ ? DecodeValue<true>(buf) : DecodeValue<false>(buf);
+}
+
+void DingoSchema<std::optional<int64_t>>::SkipValue(BufView* buf) { buf->Skip(GetLength()); }
+
+template void DingoSchema<std::optional<int64_t>>::EncodeKey<true>(Buf* buf, std::optional<int64_t> data);
+template void DingoSchema<std::optional<int64_t>>::EncodeKey<false>(Buf* buf, std::optional<int64_t> data);
+template void DingoSchema<std::optional<int64_t>>::EncodeKeyPrefix<true>(Buf* buf, std::optional<int64_t> data);
+template void DingoSchema<std::optional<int64_t>>::EncodeKeyPrefix<false>(Buf* buf, std::optional<int64_t> data);
+template std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeKey<true>(BufView* buf);
+template std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeKey<false>(BufView* buf);
+template void DingoSchema<std::optional<int64_t>>::EncodeValue<true>(Buf* buf, std::optional<int64_t> data);
+template void DingoSchema<std::optional<int64_t>>::EncodeValue<false>(Buf* buf, std::optional<int64_t> data);
+template std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeValue<true>(BufView* buf);
+template std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeValue<false>(BufView* buf);
 
-}  // namespace dingodb
\ No newline at end of file
+}  // namespace dingodb
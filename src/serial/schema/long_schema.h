@@ -27,7 +27,7 @@ template <>
 class DingoSchema<std::optional<int64_t>> : public BaseSchema {
  public:
   static void InternalEncodeKey(Buf* buf, int64_t data);
-  static int64_t InternalDecodeKey(Buf* buf);
+  static int64_t InternalDecodeKey(BufView* buf);
 
  private:
   int index_;
@@ -37,15 +37,18 @@ class DingoSchema<std::optional<int64_t>> : public BaseSchema {
   static int GetDataLength();
   static int GetWithNullTagLength();
   static void InternalEncodeNull(Buf* buf);
-  static void LeInternalEncodeKey(Buf* buf, int64_t data);
-  static void BeInternalEncodeKey(Buf* buf, int64_t data);
-  static void LeInternalEncodeValue(Buf* buf, int64_t data);
-  static void BeInternalEncodeValue(Buf* buf, int64_t data);
+  template <bool LE>
+  static void InternalEncodeKey(Buf* buf, int64_t data);
+  template <bool LE>
+  static void InternalEncodeValue(Buf* buf, int64_t data);
 
  public:
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeKey and EncodeValue.
+  int GetEncodedKeyLength(const std::optional<int64_t>& data) const;
+  int GetEncodedValueLength(const std::optional<int64_t>& data) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -54,11 +57,23 @@ class DingoSchema<std::optional<int64_t>> : public BaseSchema {
   void SetIsLe(bool le);
   void EncodeKey(Buf* buf, std::optional<int64_t> data);
   void EncodeKeyPrefix(Buf* buf, std::optional<int64_t> data);
-  std::optional<int64_t> DecodeKey(Buf* buf);
-  void SkipKey(Buf* buf);
+  std::optional<int64_t> DecodeKey(BufView* buf);
+  void SkipKey(BufView* buf);
+  void EncodeValue(Buf* buf, std::optional<int64_t> data);
+  std::optional<int64_t> DecodeValue(BufView* buf);
+  void SkipValue(BufView* buf);
+
+  // Byte order fixed at compile time, the overloads above dispatch on SetIsLe.
+  template <bool LE>
+  void EncodeKey(Buf* buf, std::optional<int64_t> data);
+  template <bool LE>
+  void EncodeKeyPrefix(Buf* buf, std::optional<int64_t> data);
+  template <bool LE>
+  std::optional<int64_t> DecodeKey(BufView* buf);
+  template <bool LE>
   void EncodeValue(Buf* buf, std::optional<int64_t> data);
-  std::optional<int64_t> DecodeValue(Buf* buf);
-  void SkipValue(Buf* buf);
+  template <bool LE>
+  std::optional<int64_t> DecodeValue(BufView* buf);
 };
 
 }  // namespace dingodb
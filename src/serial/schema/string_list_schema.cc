@@ -24,7 +24,7 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::GetDa
 int DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::GetWithNullTagLength() { return 0; }
 
 void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::InternalEmlementEncodeValue(
-    Buf* buf, const std::string& data) {
+    Buf* buf, std::string_view data) {
   buf->EnsureRemainder(data.length() + 4);
   buf->WriteInt(data.length());
   buf->Write(data);
@@ -61,6 +61,50 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::GetLe
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::InternalEncodedValueLength(
+    bool is_null, size_t count, size_t bytes) const {
+  // The list length, then every string behind its own length.
+  int size = is_null ? 0 : 4 + count * 4 + bytes;
+  return this->allow_null_ ? 1 + size : size;
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::GetEncodedValueLength(
+    const std::optional<std::shared_ptr<std::vector<std::string>>>& data) const {
+  if (!data.has_value()) {
+    return InternalEncodedValueLength(true, 0, 0);
+  }
+  size_t bytes = 0;
+  for (const std::string& str : *data.value()) {
+    bytes += str.length();
+  }
+  return InternalEncodedValueLength(false, data.value()->size(), bytes);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::GetEncodedValueLength(const RowView& row,
+                                                                                                 int column) const {
+  if (row.IsNull(column)) {
+    return InternalEncodedValueLength(true, 0, 0);
+  }
+  size_t bytes = 0;
+  for (int i = 0; i < row.GetListSize(column); i++) {
+    bytes += row.GetStringListElement(column, i).length();
+  }
+  return InternalEncodedValueLength(false, row.GetListSize(column), bytes);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::GetEncodedValueLength(
+    const ColumnVector& column, int row) const {
+  if (column.IsNull(row)) {
+    return InternalEncodedValueLength(true, 0, 0);
+  }
+  size_t bytes = 0;
+  int offset = column.GetListOffset(row);
+  for (int i = 0; i < column.GetListSize(row); i++) {
+    bytes += column.child->GetString(offset + i).length();
+  }
+  return InternalEncodedValueLength(false, column.GetListSize(row), bytes);
+}
+
 void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::SetAllowNull(bool allow_null) {
   this->allow_null_ = allow_null;
 }
@@ -78,11 +122,11 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::Enco
 }
 
 std::optional<std::shared_ptr<std::vector<std::string>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::DecodeKey(Buf* /*buf*/) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::DecodeKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::SkipKey(Buf* /*buf*/) {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::SkipKey(BufView* /*buf*/) {
   throw std::runtime_error("Unsupported EncodeKey List Type");
 }
 
@@ -106,17 +150,24 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::Enco
 }
 
 std::optional<std::shared_ptr<std::vector<std::string>>>
-DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::DecodeValue(Buf* buf) {
+DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::DecodeValue(BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return std::nullopt;
     }
   }
-  int length = buf->ReadInt();
+  // Every element takes at least its length.
+  int length = buf->ReadLength(4);
+  if (length < 0) {
+    return std::nullopt;
+  }
   std::shared_ptr<std::vector<std::string>> data = std::make_shared<std::vector<std::string>>();
   data->reserve(length);
   for (int i = 0; i < length; i++) {
-    int str_len = buf->ReadInt();
+    int str_len = buf->ReadLength(1);
+    if (str_len < 0) {
+      return std::nullopt;
+    }
     std::string str;
     for (int j = 0; j < str_len; j++) {
       str.push_back(buf->Read());
@@ -127,17 +178,86 @@ DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::DecodeVal
   return data;
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::SkipValue(Buf* buf) const {
+void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::SkipValue(BufView* buf) const {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return;
     }
   }
-  int length = buf->ReadInt();
+  int length = buf->ReadLength(4);
   for (int i = 0; i < length; i++) {
-    int str_len = buf->ReadInt();
+    int str_len = buf->ReadLength(1);
+    if (str_len < 0) {
+      return;
+    }
     buf->Skip(str_len);
   }
 }
 
+void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::EncodeValue(Buf* buf, const RowView& row,
+                                                                                        int column) {
+  if (row.IsNull(column)) {
+    EncodeValue(buf, std::nullopt);
+    return;
+  }
+  int data_size = row.GetListSize(column);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEmlementEncodeValue(buf, row.GetStringListElement(column, i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::EncodeValue(
+    Buf* buf, const ColumnVector& column, int row) {
+  if (column.IsNull(row)) {
+    EncodeValue(buf, std::nullopt);
+    return;
+  }
+  int data_size = column.GetListSize(row);
+  int offset = column.GetListOffset(row);
+  if (this->allow_null_) {
+    buf->EnsureRemainder(5);
+    buf->Write(k_not_null);
+  } else {
+    buf->EnsureRemainder(4);
+  }
+  buf->WriteInt(data_size);
+  for (int i = 0; i < data_size; i++) {
+    InternalEmlementEncodeValue(buf, column.child->GetString(offset + i));
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>>::DecodeValue(BufView* buf, Row* row,
+                                                                                        int column) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      row->SetNull(column);
+      return;
+    }
+  }
+  int length = buf->ReadLength(4);
+  if (length < 0) {
+    row->SetNull(column);
+    return;
+  }
+  row->AllocateList(column, kStringList, length);
+  for (int i = 0; i < length; i++) {
+    int str_len = buf->ReadLength(1);
+    if (str_len < 0) {
+      row->SetNull(column);
+      return;
+    }
+    char* data = row->AllocateStringListElement(column, i, str_len);
+    for (int j = 0; j < str_len; j++) {
+      data[j] = buf->Read();
+    }
+  }
+}
+
 }  // namespace dingodb
\ No newline at end of file
@@ -34,12 +34,18 @@ class DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>> : pu
   static int GetDataLength();
   static int GetWithNullTagLength();
   static void InternalEncodeValue(Buf* buf, std::shared_ptr<std::vector<std::string>> data);
-  static void InternalEmlementEncodeValue(Buf* buf, const std::string& data);
+  static void InternalEmlementEncodeValue(Buf* buf, std::string_view data);
+  // Encoded size of count strings holding bytes in total, every GetEncodedValueLength overload goes through it.
+  int InternalEncodedValueLength(bool is_null, size_t count, size_t bytes) const;
 
  public:
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeValue.
+  int GetEncodedValueLength(const std::optional<std::shared_ptr<std::vector<std::string>>>& data) const;
+  int GetEncodedValueLength(const RowView& row, int column) const;
+  int GetEncodedValueLength(const ColumnVector& column, int row) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -49,12 +55,19 @@ class DingoSchema<std::optional<std::shared_ptr<std::vector<std::string>>>> : pu
   static void EncodeKey(Buf* buf, std::optional<std::shared_ptr<std::vector<std::string>>> data);
   static void EncodeKeyPrefix(Buf* buf, std::optional<std::shared_ptr<std::vector<std::string>>> data);
   void EncodeValue(Buf* buf, std::optional<std::shared_ptr<std::vector<std::string>>> data);
-  static void SkipKey(Buf* buf);
+  static void SkipKey(BufView* buf);
 
-  static std::optional<std::shared_ptr<std::vector<std::string>>> DecodeKey(Buf* buf);
-  std::optional<std::shared_ptr<std::vector<std::string>>> DecodeValue(Buf* buf);
+  static std::optional<std::shared_ptr<std::vector<std::string>>> DecodeKey(BufView* buf);
+  std::optional<std::shared_ptr<std::vector<std::string>>> DecodeValue(BufView* buf);
 
-  void SkipValue(Buf* buf) const;
+  void SkipValue(BufView* buf) const;
+
+  // Typed row columns, the elements are read from and decoded into the row arena.
+  void EncodeValue(Buf* buf, const RowView& row, int column);
+  void DecodeValue(BufView* buf, Row* row, int column);
+
+  // Rows of a list column vector, the elements are read from its child.
+  void EncodeValue(Buf* buf, const ColumnVector& column, int row);
 };
 
 }  // namespace dingodb
@@ -14,8 +14,11 @@
 
 #include "serial/schema/string_schema.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace dingodb {
 
@@ -23,11 +26,10 @@ int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetDataLength() {
 
 int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetWithNullTagLength() { return 0; }
 
-int DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodeKey(Buf* buf,
-                                                                                std::shared_ptr<std::string> data) {
-  int group_num = data->length() / 8;
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodeKey(Buf* buf, std::string_view data) {
+  int group_num = data.length() / 8;
   int size = (group_num + 1) * 9;
-  int remainder_size = data->length() % 8;
+  int remainder_size = data.length() % 8;
   int remainder_zero;
   if (remainder_size == 0) {
     remainder_size = 8;
@@ -39,13 +41,13 @@ int DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodeKey(
   int curr = 0;
   for (int i = 0; i < group_num; i++) {
     for (int j = 0; j < 8; j++) {
-      buf->Write(data->at(curr++));
+      buf->Write(data.at(curr++));
     }
     buf->Write((uint8_t)255);
   }
   if (remainder_size < 8) {
     for (int j = 0; j < remainder_size; j++) {
-      buf->Write(data->at(curr++));
+      buf->Write(data.at(curr++));
     }
   }
   for (int i = 0; i < remainder_zero; i++) {
@@ -55,11 +57,29 @@ int DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodeKey(
   return size;
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodeValue(Buf* buf,
-                                                                                   std::shared_ptr<std::string> data) {
-  buf->EnsureRemainder(data->length() + 4);
-  buf->WriteInt(data->length());
-  buf->Write(*data);
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodeValue(Buf* buf, std::string_view data) {
+  buf->EnsureRemainder(data.length() + 4);
+  buf->WriteInt(data.length());
+  buf->Write(data);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::DecodeKeyLength(BufView* buf, int* ori_length) {
+  if (!buf->CheckReverseRemainder(4)) {
+    return -1;
+  }
+  int length = buf->ReverseReadInt();
+  if (length <= 0 || length % 9 != 0 || !buf->CheckRemainder(length)) {
+    buf->SetCorrupt();
+    return -1;
+  }
+  // The last group ends in 255 less the zeros padding it.
+  int remainder_zero = 255 - static_cast<uint8_t>(buf->Data()[buf->GetForwardPos() + length - 1]);
+  if (remainder_zero > 8) {
+    buf->SetCorrupt();
+    return -1;
+  }
+  *ori_length = length / 9 * 8 - remainder_zero;
+  return length;
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetType() { return kString; }
@@ -79,6 +99,52 @@ int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetLength() {
   return GetDataLength();
 }
 
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodedKeyLength(
+    bool is_null, size_t length) const {
+  // 9 bytes per started group of 8, plus the length written from the tail. A null key still writes the length.
+  int size = is_null ? 0 : (length / 8 + 1) * 9 + 4;
+  if (this->allow_null_) {
+    return is_null ? 5 : 1 + size;
+  }
+  return size;
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodedValueLength(
+    bool is_null, size_t length) const {
+  int size = is_null ? 0 : 4 + length;
+  return this->allow_null_ ? 1 + size : size;
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetEncodedKeyLength(
+    const std::optional<std::shared_ptr<std::string>>& data) const {
+  return InternalEncodedKeyLength(!data.has_value(), data.has_value() ? data.value()->length() : 0);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetEncodedValueLength(
+    const std::optional<std::shared_ptr<std::string>>& data) const {
+  return InternalEncodedValueLength(!data.has_value(), data.has_value() ? data.value()->length() : 0);
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetEncodedKeyLength(const RowView& row,
+                                                                                  int column) const {
+  return InternalEncodedKeyLength(row.IsNull(column), row.IsNull(column) ? 0 : row.GetString(column).length());
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetEncodedValueLength(const RowView& row,
+                                                                                    int column) const {
+  return InternalEncodedValueLength(row.IsNull(column), row.IsNull(column) ? 0 : row.GetString(column).length());
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetEncodedKeyLength(const ColumnVector& column,
+                                                                                  int row) const {
+  return InternalEncodedKeyLength(column.IsNull(row), column.IsNull(row) ? 0 : column.GetString(row).length());
+}
+
+int DingoSchema<std::optional<std::shared_ptr<std::string>>>::GetEncodedValueLength(const ColumnVector& column,
+                                                                                    int row) const {
+  return InternalEncodedValueLength(column.IsNull(row), column.IsNull(row) ? 0 : column.GetString(row).length());
+}
+
 void DingoSchema<std::optional<std::shared_ptr<std::string>>>::SetAllowNull(bool allow_null) {
   this->allow_null_ = allow_null;
 }
@@ -91,7 +157,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeKey(
     if (data.has_value()) {
       buf->EnsureRemainder(1);
       buf->Write(k_not_null);
-      int size = InternalEncodeKey(buf, data.value());
+      int size = InternalEncodeKey(buf, *data.value());
       buf->EnsureRemainder(4);
       buf->ReverseWriteInt(size);
     } else {
@@ -101,7 +167,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeKey(
     }
   } else {
     if (data.has_value()) {
-      int size = InternalEncodeKey(buf, data.value());
+      int size = InternalEncodeKey(buf, *data.value());
       buf->EnsureRemainder(4);
       buf->ReverseWriteInt(size);
     } else {
@@ -116,14 +182,14 @@ void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeKeyPrefix(
     if (data.has_value()) {
       buf->EnsureRemainder(1);
       buf->Write(k_not_null);
-      InternalEncodeKey(buf, data.value());
+      InternalEncodeKey(buf, *data.value());
     } else {
       buf->EnsureRemainder(1);
       buf->Write(k_null);
     }
   } else {
     if (data.has_value()) {
-      InternalEncodeKey(buf, data.value());
+      InternalEncodeKey(buf, *data.value());
     } else {
       // WRONG EMPTY DATA
     }
@@ -131,19 +197,20 @@ void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeKeyPrefix(
 }
 
 std::optional<std::shared_ptr<std::string>> DingoSchema<std::optional<std::shared_ptr<std::string>>>::DecodeKey(
-    Buf* buf) {
+    BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       buf->ReverseSkipInt();
       return std::nullopt;
     }
   }
-  int length = buf->ReverseReadInt();
+  int ori_length;
+  int length = DecodeKeyLength(buf, &ori_length);
+  if (length < 0) {
+    return std::nullopt;
+  }
   int group_num = length / 9;
-  buf->Skip(length - 1);
-  int remainder_zero = 255 - (buf->Read() & 0xFF);
-  buf->Skip(0 - length);
-  int ori_length = group_num * 8 - remainder_zero;
+  int remainder_zero = group_num * 8 - ori_length;
   auto data = std::make_shared<std::string>(ori_length, 0);
 
   if (ori_length != 0) {
@@ -168,11 +235,14 @@ std::optional<std::shared_ptr<std::string>> DingoSchema<std::optional<std::share
   return std::optional<std::shared_ptr<std::string>>(data);
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::string>>>::SkipKey(Buf* buf) const {
-  if (this->allow_null_) {
-    buf->Skip(buf->ReverseReadInt() + 1);
-  } else {
-    buf->Skip(buf->ReverseReadInt());
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::SkipKey(BufView* buf) const {
+  if (!buf->CheckReverseRemainder(4)) {
+    return;
+  }
+  // Null keys store a zero length behind their tag.
+  int64_t length = static_cast<int64_t>(buf->ReverseReadInt()) + (this->allow_null_ ? 1 : 0);
+  if (buf->CheckRemainder(length)) {
+    buf->Skip(length);
   }
 }
 
@@ -182,13 +252,13 @@ void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeValue(
     buf->EnsureRemainder(1);
     if (data.has_value()) {
       buf->Write(k_not_null);
-      InternalEncodeValue(buf, data.value());
+      InternalEncodeValue(buf, *data.value());
     } else {
       buf->Write(k_null);
     }
   } else {
     if (data.has_value()) {
-      InternalEncodeValue(buf, data.value());
+      InternalEncodeValue(buf, *data.value());
     } else {
       // WRONG EMPTY DATA
     }
@@ -196,13 +266,16 @@ void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeValue(
 }
 
 std::optional<std::shared_ptr<std::string>> DingoSchema<std::optional<std::shared_ptr<std::string>>>::DecodeValue(
-    Buf* buf) {
+    BufView* buf) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
       return std::nullopt;
     }
   }
-  int length = buf->ReadInt();
+  int length = buf->ReadLength(1);
+  if (length < 0) {
+    return std::nullopt;
+  }
   auto su8 = std::make_shared<std::string>(length, 0);
 
   for (int i = 0; i < length; i++) {
@@ -212,13 +285,183 @@ std::optional<std::shared_ptr<std::string>> DingoSchema<std::optional<std::share
   return std::optional<std::shared_ptr<std::string>>{su8};
 }
 
-void DingoSchema<std::optional<std::shared_ptr<std::string>>>::SkipValue(Buf* buf) const {
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::SkipValue(BufView* buf) const {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      return;
+    }
+  }
+  int length = buf->ReadLength(1);
+  if (length >= 0) {
+    buf->Skip(length);
+  }
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeKey(Buf* buf, const RowView& row, int column) {
+  if (row.IsNull(column)) {
+    EncodeKey(buf, std::nullopt);
+    return;
+  }
+  if (this->allow_null_) {
+    buf->EnsureRemainder(1);
+    buf->Write(k_not_null);
+  }
+  int size = InternalEncodeKey(buf, row.GetString(column));
+  buf->EnsureRemainder(4);
+  buf->ReverseWriteInt(size);
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeKeyPrefix(Buf* buf, const RowView& row,
+                                                                               int column) {
+  if (row.IsNull(column)) {
+    EncodeKeyPrefix(buf, std::nullopt);
+    return;
+  }
+  if (this->allow_null_) {
+    buf->EnsureRemainder(1);
+    buf->Write(k_not_null);
+  }
+  InternalEncodeKey(buf, row.GetString(column));
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeValue(Buf* buf, const RowView& row, int column) {
+  if (row.IsNull(column)) {
+    EncodeValue(buf, std::nullopt);
+    return;
+  }
+  if (this->allow_null_) {
+    buf->EnsureRemainder(1);
+    buf->Write(k_not_null);
+  }
+  InternalEncodeValue(buf, row.GetString(column));
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeKey(Buf* buf, const ColumnVector& column,
+                                                                         int row) {
+  if (column.IsNull(row)) {
+    EncodeKey(buf, std::nullopt);
+    return;
+  }
+  if (this->allow_null_) {
+    buf->EnsureRemainder(1);
+    buf->Write(k_not_null);
+  }
+  int size = InternalEncodeKey(buf, column.GetString(row));
+  buf->EnsureRemainder(4);
+  buf->ReverseWriteInt(size);
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::EncodeValue(Buf* buf, const ColumnVector& column,
+                                                                           int row) {
+  if (column.IsNull(row)) {
+    EncodeValue(buf, std::nullopt);
+    return;
+  }
+  if (this->allow_null_) {
+    buf->EnsureRemainder(1);
+    buf->Write(k_not_null);
+  }
+  InternalEncodeValue(buf, column.GetString(row));
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::DecodeKey(BufView* buf, Row* row, int column) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      buf->ReverseSkipInt();
+      row->SetNull(column);
+      return;
+    }
+  }
+  int ori_length;
+  int length = DecodeKeyLength(buf, &ori_length);
+  if (length < 0) {
+    row->SetNull(column);
+    return;
+  }
+  int group_num = length / 9;
+  int remainder_zero = group_num * 8 - ori_length;
+  char* data = row->AllocateString(column, ori_length);
+
+  if (ori_length != 0) {
+    int curr = 0;
+    group_num--;
+    for (int i = 0; i < group_num; i++) {
+      for (int j = 0; j < 8; j++) {
+        data[curr++] = buf->Read();
+      }
+      buf->Skip(1);
+    }
+    if (remainder_zero != 8) {
+      int non_zero_count = 8 - remainder_zero;
+      for (int j = 0; j < non_zero_count; j++) {
+        data[curr++] = buf->Read();
+      }
+    }
+  }
+
+  buf->Skip(remainder_zero + 1);
+}
+
+void DingoSchema<std::optional<std::shared_ptr<std::string>>>::DecodeValue(BufView* buf, Row* row, int column) {
   if (this->allow_null_) {
     if (buf->Read() == this->k_null) {
+      row->SetNull(column);
       return;
     }
   }
-  buf->Skip(buf->ReadInt());
+  int length = buf->ReadLength(1);
+  if (length < 0) {
+    row->SetNull(column);
+    return;
+  }
+  char* data = row->AllocateString(column, length);
+
+  for (int i = 0; i < length; i++) {
+    data[i] = buf->Read();
+  }
+}
+
+std::optional<std::string_view> DingoSchema<std::optional<std::shared_ptr<std::string>>>::DecodeKeyView(
+    BufView* buf, StringArena* arena) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      buf->ReverseSkipInt();
+      return std::nullopt;
+    }
+  }
+  int ori_length;
+  int length = DecodeKeyLength(buf, &ori_length);
+  if (length < 0) {
+    return std::nullopt;
+  }
+  const char* groups = buf->Data() + buf->GetForwardPos();
+  buf->Skip(length);
+  if (ori_length <= 8) {
+    // Contiguous in the first group.
+    return std::string_view(groups, ori_length);
+  }
+
+  char* data = arena->Allocate(ori_length);
+  for (int curr = 0; curr < ori_length; curr += 8) {
+    memcpy(data + curr, groups + curr / 8 * 9, std::min(8, ori_length - curr));
+  }
+  return std::string_view(data, ori_length);
+}
+
+std::optional<std::string_view> DingoSchema<std::optional<std::shared_ptr<std::string>>>::DecodeValueView(
+    BufView* buf) {
+  if (this->allow_null_) {
+    if (buf->Read() == this->k_null) {
+      return std::nullopt;
+    }
+  }
+  int length = buf->ReadLength(1);
+  if (length < 0) {
+    return std::nullopt;
+  }
+  std::string_view data(buf->Data() + buf->GetForwardPos(), length);
+  buf->Skip(length);
+  return data;
 }
 
-}  // namespace dingodb
\ No newline at end of file
+}  // namespace dingodb
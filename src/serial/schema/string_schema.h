@@ -19,8 +19,10 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <string_view>
 
 #include "serial/schema/dingo_schema.h"
+#include "serial/string_arena.h"
 
 namespace dingodb {
 
@@ -33,13 +35,27 @@ class DingoSchema<std::optional<std::shared_ptr<std::string>>> : public BaseSche
 
   static int GetDataLength();
   static int GetWithNullTagLength();
-  static int InternalEncodeKey(Buf* buf, std::shared_ptr<std::string> data);
-  static void InternalEncodeValue(Buf* buf, std::shared_ptr<std::string> data);
+  static int InternalEncodeKey(Buf* buf, std::string_view data);
+  static void InternalEncodeValue(Buf* buf, std::string_view data);
+  // Encoded sizes of a column holding length bytes, every GetEncoded*Length overload goes through these.
+  int InternalEncodedKeyLength(bool is_null, size_t length) const;
+  int InternalEncodedValueLength(bool is_null, size_t length) const;
 
  public:
+  // Bytes of the groups of a key string, read from the tail, and the length of the string they hold. -1 if they run
+  // past the view or do not end in a valid marker. Shared with StaticRecordCodec.
+  static int DecodeKeyLength(BufView* buf, int* ori_length);
+
   Type GetType() override;
   bool AllowNull() override;
   int GetLength() override;
+  // Exact number of bytes written by EncodeKey and EncodeValue.
+  int GetEncodedKeyLength(const std::optional<std::shared_ptr<std::string>>& data) const;
+  int GetEncodedValueLength(const std::optional<std::shared_ptr<std::string>>& data) const;
+  int GetEncodedKeyLength(const RowView& row, int column) const;
+  int GetEncodedValueLength(const RowView& row, int column) const;
+  int GetEncodedKeyLength(const ColumnVector& column, int row) const;
+  int GetEncodedValueLength(const ColumnVector& column, int row) const;
   bool IsKey() override;
   int GetIndex() override;
   void SetIndex(int index);
@@ -50,12 +66,29 @@ class DingoSchema<std::optional<std::shared_ptr<std::string>>> : public BaseSche
   void EncodeKeyPrefix(Buf* buf, std::optional<std::shared_ptr<std::string>> data);
   void EncodeValue(Buf* buf, std::optional<std::shared_ptr<std::string>> data);
 
-  void SkipKey(Buf* buf) const;
+  void SkipKey(BufView* buf) const;
+
+  std::optional<std::shared_ptr<std::string>> DecodeKey(BufView* buf);
+  std::optional<std::shared_ptr<std::string>> DecodeValue(BufView* buf);
+
+  void SkipValue(BufView* buf) const;
+
+  // Typed row columns, strings are read from and decoded into the row arena without a shared_ptr per cell.
+  void EncodeKey(Buf* buf, const RowView& row, int column);
+  void EncodeKeyPrefix(Buf* buf, const RowView& row, int column);
+  void EncodeValue(Buf* buf, const RowView& row, int column);
+  void DecodeKey(BufView* buf, Row* row, int column);
+  void DecodeValue(BufView* buf, Row* row, int column);
 
-  std::optional<std::shared_ptr<std::string>> DecodeKey(Buf* buf);
-  std::optional<std::shared_ptr<std::string>> DecodeValue(Buf* buf);
+  // Rows of a string column vector, read in place.
+  void EncodeKey(Buf* buf, const ColumnVector& column, int row);
+  void EncodeValue(Buf* buf, const ColumnVector& column, int row);
 
-  void SkipValue(Buf* buf) const;
+  // Views instead of copies, nullopt for null. A value string is viewed in place, so is a key string that fits in
+  // its first group; longer key strings are decoded into arena. The views live as long as the encoded bytes and
+  // the arena.
+  std::optional<std::string_view> DecodeKeyView(BufView* buf, StringArena* arena);
+  std::optional<std::string_view> DecodeValueView(BufView* buf);
 };
 
 }  // namespace dingodb
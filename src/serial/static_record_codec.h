@@ -0,0 +1,608 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_STATIC_RECORD_CODEC_H_
+#define DINGO_SERIAL_STATIC_RECORD_CODEC_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "serial/buf.h"
+#include "serial/buf_view.h"
+#include "serial/byte_order.h"
+#include "serial/output_sink.h"
+#include "serial/schema/boolean_schema.h"
+#include "serial/schema/double_schema.h"
+#include "serial/schema/float_schema.h"
+#include "serial/schema/integer_schema.h"
+#include "serial/schema/long_schema.h"
+#include "serial/schema/string_schema.h"
+
+namespace dingodb {
+
+// Column types of a StaticRecordCodec, each one encodes exactly like the DingoSchema of the same type. Columns are
+// not nullable unless wrapped in Nullable<>.
+struct Bool {
+  using Type = bool;
+  using Schema = DingoSchema<std::optional<bool>>;
+  static constexpr int kWidth = 1;
+
+  template <bool LE>
+  static void EncodeKeyData(Buf& buf, bool data) {
+    buf.Write(data);
+  }
+  template <bool LE>
+  static void EncodeValueData(Buf& buf, bool data) {
+    buf.Write(data);
+  }
+  template <bool LE>
+  static bool DecodeKeyData(BufView& buf) {
+    return buf.Read();
+  }
+  template <bool LE>
+  static bool DecodeValueData(BufView& buf) {
+    return buf.Read();
+  }
+};
+
+struct Int {
+  using Type = int32_t;
+  using Schema = DingoSchema<std::optional<int32_t>>;
+  static constexpr int kWidth = 4;
+
+  template <bool LE>
+  static void EncodeKeyData(Buf& buf, int32_t data) {
+    buf.WriteInt<LE>(data ^ kKeyFlip32<LE>);
+  }
+  template <bool LE>
+  static void EncodeValueData(Buf& buf, int32_t data) {
+    buf.WriteInt<LE>(data);
+  }
+  template <bool LE>
+  static int32_t DecodeKeyData(BufView& buf) {
+    return static_cast<int32_t>(buf.ReadInt<LE>() ^ kKeyFlip32<LE>);
+  }
+  template <bool LE>
+  static int32_t DecodeValueData(BufView& buf) {
+    return buf.ReadInt<LE>();
+  }
+};
+
+// Float schemas keep their own byte order (see FormatSchema), so floats ignore the codec one.
+struct Float {
+  using Type = float;
+  using Schema = DingoSchema<std::optional<float>>;
+  static constexpr int kWidth = 4;
+
+  template <bool LE>
+  static void EncodeKeyData(Buf& buf, float data) {
+    uint32_t bits;
+    memcpy(&bits, &data, 4);
+    buf.WriteInt<true>(data >= 0 ? bits ^ kKeyFlip32<true> : ~bits);
+  }
+  template <bool LE>
+  static void EncodeValueData(Buf& buf, float data) {
+    uint32_t bits;
+    memcpy(&bits, &data, 4);
+    buf.WriteInt<true>(bits);
+  }
+  template <bool LE>
+  static float DecodeKeyData(BufView& buf) {
+    uint32_t bits = buf.ReadInt<true>();
+    bits = (bits & kKeyFlip32<true>) ? bits ^ kKeyFlip32<true> : ~bits;
+    float data;
+    memcpy(&data, &bits, 4);
+    return data;
+  }
+  template <bool LE>
+  static float DecodeValueData(BufView& buf) {
+    uint32_t bits = buf.ReadInt<true>();
+    float data;
+    memcpy(&data, &bits, 4);
+    return data;
+  }
+};
+
+struct Long {
+  using Type = int64_t;
+  using Schema = DingoSchema<std::optional<int64_t>>;
+  static constexpr int kWidth = 8;
+
+  template <bool LE>
+  static void EncodeKeyData(Buf& buf, int64_t data) {
+    buf.WriteLong<LE>(data ^ kKeyFlip64<LE>);
+  }
+  template <bool LE>
+  static void EncodeValueData(Buf& buf, int64_t data) {
+    buf.WriteLong<LE>(data);
+  }
+  template <bool LE>
+  static int64_t DecodeKeyData(BufView& buf) {
+    return static_cast<int64_t>(buf.ReadLong<LE>() ^ kKeyFlip64<LE>);
+  }
+  template <bool LE>
+  static int64_t DecodeValueData(BufView& buf) {
+    return buf.ReadLong<LE>();
+  }
+};
+
+struct Double {
+  using Type = double;
+  using Schema = DingoSchema<std::optional<double>>;
+  static constexpr int kWidth = 8;
+
+  template <bool LE>
+  static void EncodeKeyData(Buf& buf, double data) {
+    uint64_t bits;
+    memcpy(&bits, &data, 8);
+    buf.WriteLong<LE>(data >= 0 ? bits ^ kKeyFlip64<LE> : ~bits);
+  }
+  template <bool LE>
+  static void EncodeValueData(Buf& buf, double data) {
+    uint64_t bits;
+    memcpy(&bits, &data, 8);
+    buf.WriteLong<LE>(bits);
+  }
+  template <bool LE>
+  static double DecodeKeyData(BufView& buf) {
+    uint64_t bits = buf.ReadLong<LE>();
+    bits = (bits & kKeyFlip64<LE>) ? bits ^ kKeyFlip64<LE> : ~bits;
+    double data;
+    memcpy(&data, &bits, 8);
+    return data;
+  }
+  template <bool LE>
+  static double DecodeValueData(BufView& buf) {
+    uint64_t bits = buf.ReadLong<LE>();
+    double data;
+    memcpy(&data, &bits, 8);
+    return data;
+  }
+};
+
+// Variable length, encoded by StaticColumnCodec itself.
+struct String {
+  using Type = std::string;
+  using Schema = DingoSchema<std::optional<std::shared_ptr<std::string>>>;
+};
+
+template <typename Column>
+struct Nullable {};
+
+// Record field of a column: the plain type, or an optional for a Nullable<> column.
+template <typename Spec>
+struct StaticColumn {
+  using Column = Spec;
+  using Data = typename Spec::Type;
+  static constexpr bool kNullable = false;
+
+  static const typename Spec::Type* Get(const Data& data) { return &data; }
+  static typename Spec::Type& Emplace(Data& data) { return data; }
+};
+
+template <typename Spec>
+struct StaticColumn<Nullable<Spec>> {
+  using Column = Spec;
+  using Data = std::optional<typename Spec::Type>;
+  static constexpr bool kNullable = true;
+
+  static const typename Spec::Type* Get(const Data& data) { return data.has_value() ? &data.value() : nullptr; }
+  static typename Spec::Type& Emplace(Data& data) {
+    if (!data.has_value()) {
+      data.emplace();
+    }
+    return data.value();
+  }
+};
+
+// Encoding of one column, byte for byte the one of its DingoSchema, including the null layouts.
+template <typename Spec, bool LE>
+struct StaticColumnCodec {
+  using Traits = StaticColumn<Spec>;
+  using Column = typename Traits::Column;
+  using Data = typename Traits::Data;
+  static constexpr bool kNullable = Traits::kNullable;
+  static constexpr bool kString = std::is_same_v<Column, String>;
+  static constexpr uint8_t kNull = 0;
+  static constexpr uint8_t kNotNull = 1;
+
+  static void WriteZeros(Buf& buf, int size) { buf.Write(std::string_view("\0\0\0\0\0\0\0\0", size)); }
+
+  static int KeyLength(const Data& data) {
+    const auto* value = Traits::Get(data);
+    if constexpr (kString) {
+      int size = value != nullptr ? (value->length() / 8 + 1) * 9 + 4 : 0;
+      return kNullable ? (value != nullptr ? 1 + size : 5) : size;
+    } else if constexpr (kNullable) {
+      // A null bool key only writes its tag.
+      return value != nullptr || !std::is_same_v<Column, Bool> ? 1 + Column::kWidth : 1;
+    } else {
+      return Column::kWidth;
+    }
+  }
+
+  static int ValueLength(const Data& data) {
+    if constexpr (kString) {
+      const auto* value = Traits::Get(data);
+      int size = value != nullptr ? 4 + value->length() : 0;
+      return kNullable ? 1 + size : size;
+    } else {
+      return kNullable ? 1 + Column::kWidth : Column::kWidth;
+    }
+  }
+
+  // Groups of 8 bytes each followed by a marker, the last group is zero padded and its marker counts the padding.
+  static int EncodeStringKey(Buf& buf, const std::string& data) {
+    int group_num = data.length() / 8;
+    int remainder_size = data.length() % 8;
+    for (int i = 0; i < group_num; i++) {
+      buf.Write(std::string_view(data.data() + i * 8, 8));
+      buf.Write(static_cast<uint8_t>(255));
+    }
+    buf.Write(std::string_view(data.data() + group_num * 8, remainder_size));
+    WriteZeros(buf, 8 - remainder_size);
+    buf.Write(static_cast<uint8_t>(255 - (8 - remainder_size)));
+    return (group_num + 1) * 9;
+  }
+
+  static void EncodeKey(Buf& buf, const Data& data) {
+    const auto* value = Traits::Get(data);
+    if constexpr (kNullable) {
+      buf.Write(value != nullptr ? kNotNull : kNull);
+      if (value == nullptr) {
+        if constexpr (kString) {
+          buf.ReverseWriteInt<LE>(0);
+        } else if constexpr (!std::is_same_v<Column, Bool>) {
+          WriteZeros(buf, Column::kWidth);
+        }
+        return;
+      }
+    }
+    if constexpr (kString) {
+      buf.ReverseWriteInt<LE>(EncodeStringKey(buf, *value));
+    } else {
+      Column::template EncodeKeyData<LE>(buf, *value);
+    }
+  }
+
+  static void EncodeValue(Buf& buf, const Data& data) {
+    const auto* value = Traits::Get(data);
+    if constexpr (kNullable) {
+      buf.Write(value != nullptr ? kNotNull : kNull);
+      if (value == nullptr) {
+        if constexpr (!kString) {
+          WriteZeros(buf, Column::kWidth);
+        }
+        return;
+      }
+    }
+    if constexpr (kString) {
+      buf.WriteInt<LE>(value->length());
+      buf.Write(*value);
+    } else {
+      Column::template EncodeValueData<LE>(buf, *value);
+    }
+  }
+
+  static void DecodeKey(BufView& buf, Data& data) {
+    // Past the end after the column before it.
+    if (!buf.CheckRemainder(1)) {
+      return;
+    }
+    if constexpr (kNullable) {
+      if (buf.Read() == kNull) {
+        if constexpr (kString) {
+          buf.ReverseSkipInt();
+        } else {
+          buf.Skip(Column::kWidth);
+        }
+        data = std::nullopt;
+        return;
+      }
+    }
+    if constexpr (kString) {
+      int ori_length;
+      int length = Column::Schema::DecodeKeyLength(&buf, &ori_length);
+      if (length < 0) {
+        return;
+      }
+      int group_num = length / 9;
+      int remainder_zero = group_num * 8 - ori_length;
+      std::string& value = Traits::Emplace(data);
+      value.resize(ori_length);
+      for (int i = 0; i < group_num - 1; i++) {
+        memcpy(value.data() + i * 8, buf.Data() + buf.GetForwardPos(), 8);
+        buf.Skip(9);
+      }
+      memcpy(value.data() + (group_num - 1) * 8, buf.Data() + buf.GetForwardPos(), 8 - remainder_zero);
+      buf.Skip(9);
+    } else if (buf.CheckRemainder(Column::kWidth)) {
+      Traits::Emplace(data) = Column::template DecodeKeyData<LE>(buf);
+    }
+  }
+
+  // False when a non-nullable column is missing from a value written by an older, narrower schema, or the column
+  // runs past the end of the value.
+  static bool DecodeValue(BufView& buf, Data& data) {
+    if (buf.IsEnd()) {
+      if constexpr (kNullable) {
+        data = std::nullopt;
+        return true;
+      }
+      return false;
+    }
+    if (!buf.CheckRemainder(1)) {
+      return false;
+    }
+    if constexpr (kNullable) {
+      if (buf.Read() == kNull) {
+        if constexpr (!kString) {
+          buf.Skip(Column::kWidth);
+        }
+        data = std::nullopt;
+        return true;
+      }
+    }
+    if constexpr (kString) {
+      int length = buf.ReadLength(1);
+      if (length < 0) {
+        return false;
+      }
+      Traits::Emplace(data).assign(buf.Data() + buf.GetForwardPos(), length);
+      buf.Skip(length);
+    } else {
+      if (!buf.CheckRemainder(Column::kWidth)) {
+        return false;
+      }
+      Traits::Emplace(data) = Column::template DecodeValueData<LE>(buf);
+    }
+    return true;
+  }
+};
+
+template <typename... Columns>
+struct Key {};
+
+template <typename... Columns>
+struct Value {};
+
+// Record codec for a table shape known at compile time, e.g.
+//
+//   StaticRecordCodec<Key<Long, String>, Value<Int, Nullable<Double>, String>>
+//
+// Its output is byte-identical to RecordEncoder/RecordDecoder over CreateSchemas(), but widths, null tags and the
+// byte order are resolved by the templates, so the per-column code inlines into straight-line stores. Records are
+// tuples with the key columns first; a struct can be passed through std::tie of its fields. LE is the codec `le`.
+template <typename KeyColumns, typename ValueColumns, bool LE = kHostLE>
+class StaticRecordCodec;
+
+template <typename... KeyColumns, typename... ValueColumns, bool LE>
+class StaticRecordCodec<Key<KeyColumns...>, Value<ValueColumns...>, LE> {
+ public:
+  using Record = std::tuple<typename StaticColumn<KeyColumns>::Data..., typename StaticColumn<ValueColumns>::Data...>;
+  static constexpr size_t kKeyColumns = sizeof...(KeyColumns);
+  static constexpr size_t kValueColumns = sizeof...(ValueColumns);
+
+  StaticRecordCodec(int schema_version, long common_id) : schema_version_(schema_version), common_id_(common_id) {}
+
+  // The equivalent schemas for the dynamic codec, key columns first and every index equal to its position.
+  static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> CreateSchemas() {
+    auto schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    int index = 0;
+    (schemas->push_back(CreateSchema<KeyColumns>(index++, true)), ...);
+    (schemas->push_back(CreateSchema<ValueColumns>(index++, false)), ...);
+    return schemas;
+  }
+
+  template <typename Tuple>
+  int EncodedKeySize(const Tuple& record) const {
+    CheckArity<Tuple>();
+    return KeySize(record, std::index_sequence_for<KeyColumns...>());
+  }
+
+  template <typename Tuple>
+  int EncodedValueSize(const Tuple& record) const {
+    CheckArity<Tuple>();
+    return ValueSize(record, std::index_sequence_for<ValueColumns...>());
+  }
+
+  template <typename Tuple>
+  int Encode(char prefix, const Tuple& record, std::string& key, std::string& value) const {
+    if (EncodeKey(prefix, record, key) < 0 || EncodeValue(record, value) < 0) {
+      return -1;
+    }
+    return 0;
+  }
+
+  template <typename Tuple>
+  int EncodeKey(char prefix, const Tuple& record, std::string& output) const {
+    output.clear();
+    StringSink sink(&output);
+    return EncodeKey(prefix, record, sink);
+  }
+
+  template <typename Tuple>
+  int EncodeKey(char prefix, const Tuple& record, OutputSink& output) const {
+    int size = EncodedKeySize(record);
+    char* data = output.Reserve(size);
+    if (data == nullptr) {
+      return -1;
+    }
+    Buf buf(data, size, LE);
+    // |namespace|id| ... |tag|
+    buf.Write(prefix);
+    buf.WriteLong<LE>(common_id_);
+    buf.ReverseWrite(kCodecVersion);
+    buf.ReverseWrite(0);
+    buf.ReverseWrite(0);
+    buf.ReverseWrite(0);
+    EncodeKeyColumns(buf, record, std::index_sequence_for<KeyColumns...>());
+
+    if (!buf.IsFilled(data)) {
+      //"Wrong Encoded Size"
+      return -1;
+    }
+    return size;
+  }
+
+  template <typename Tuple>
+  int EncodeValue(const Tuple& record, std::string& output) const {
+    output.clear();
+    StringSink sink(&output);
+    return EncodeValue(record, sink);
+  }
+
+  template <typename Tuple>
+  int EncodeValue(const Tuple& record, OutputSink& output) const {
+    int size = EncodedValueSize(record);
+    char* data = output.Reserve(size);
+    if (data == nullptr) {
+      return -1;
+    }
+    Buf buf(data, size, LE);
+    buf.WriteInt<LE>(schema_version_);
+    EncodeValueColumns(buf, record, std::index_sequence_for<ValueColumns...>());
+
+    if (!buf.IsFilled(data)) {
+      //"Wrong Encoded Size"
+      return -1;
+    }
+    return size;
+  }
+
+  // Tuple is a Record or a tuple of references to its fields.
+  template <typename Tuple>
+  int Decode(std::string_view key, std::string_view value, Tuple&& record) const {
+    CheckArity<Tuple>();
+    BufView key_buf(key, LE);
+    BufView value_buf(value, LE);
+    if (!CheckKey(key_buf)) {
+      return -1;
+    }
+    if (value_buf.Size() < 4 || value_buf.ReadInt<LE>() > schema_version_) {
+      //"Wrong Schema Version"
+      return -1;
+    }
+    DecodeKeyColumns(key_buf, record, std::index_sequence_for<KeyColumns...>());
+    if (key_buf.IsCorrupt()) {
+      //"Length Past The End"
+      return -1;
+    }
+    if (!DecodeValueColumns(value_buf, record, std::index_sequence_for<ValueColumns...>())) {
+      //"Missing Value Column"
+      return -1;
+    }
+    return 0;
+  }
+
+  // Only the key columns of record are written.
+  template <typename Tuple>
+  int DecodeKey(std::string_view key, Tuple&& record) const {
+    CheckArity<Tuple>();
+    BufView key_buf(key, LE);
+    if (!CheckKey(key_buf)) {
+      return -1;
+    }
+    DecodeKeyColumns(key_buf, record, std::index_sequence_for<KeyColumns...>());
+    if (key_buf.IsCorrupt()) {
+      //"Length Past The End"
+      return -1;
+    }
+    return 0;
+  }
+
+ private:
+  static constexpr uint8_t kCodecVersion = 1;
+
+  int schema_version_;
+  long common_id_;
+
+  template <typename Tuple>
+  static constexpr void CheckArity() {
+    static_assert(std::tuple_size_v<std::remove_reference_t<Tuple>> == kKeyColumns + kValueColumns,
+                  "record does not match the columns");
+  }
+
+  template <typename Spec>
+  static std::shared_ptr<BaseSchema> CreateSchema(int index, bool key) {
+    auto schema = std::make_shared<typename StaticColumn<Spec>::Column::Schema>();
+    schema->SetIndex(index);
+    schema->SetIsKey(key);
+    schema->SetAllowNull(StaticColumn<Spec>::kNullable);
+    return schema;
+  }
+
+  bool CheckKey(BufView& buf) const {
+    // |namespace|id| ... |tag|, a shorter key is truncated.
+    if (buf.Size() < 13) {
+      return false;
+    }
+    // skip name space
+    buf.Skip(1);
+    if (buf.ReadLong<LE>() != common_id_) {
+      //"Wrong Common Id"
+      return false;
+    }
+    if (buf.ReverseRead() > kCodecVersion) {
+      //"Wrong Codec Version"
+      return false;
+    }
+    buf.ReverseSkip(3);
+    return true;
+  }
+
+  template <typename Tuple, size_t... I>
+  static int KeySize(const Tuple& record, std::index_sequence<I...> /*columns*/) {
+    // |namespace|id| ... |tag|
+    return (13 + ... + StaticColumnCodec<KeyColumns, LE>::KeyLength(std::get<I>(record)));
+  }
+
+  template <typename Tuple, size_t... I>
+  static int ValueSize(const Tuple& record, std::index_sequence<I...> /*columns*/) {
+    // |schema version| ...
+    return (4 + ... + StaticColumnCodec<ValueColumns, LE>::ValueLength(std::get<kKeyColumns + I>(record)));
+  }
+
+  template <typename Tuple, size_t... I>
+  static void EncodeKeyColumns(Buf& buf, const Tuple& record, std::index_sequence<I...> /*columns*/) {
+    (StaticColumnCodec<KeyColumns, LE>::EncodeKey(buf, std::get<I>(record)), ...);
+  }
+
+  template <typename Tuple, size_t... I>
+  static void EncodeValueColumns(Buf& buf, const Tuple& record, std::index_sequence<I...> /*columns*/) {
+    (StaticColumnCodec<ValueColumns, LE>::EncodeValue(buf, std::get<kKeyColumns + I>(record)), ...);
+  }
+
+  template <typename Tuple, size_t... I>
+  static void DecodeKeyColumns(BufView& buf, Tuple& record, std::index_sequence<I...> /*columns*/) {
+    (StaticColumnCodec<KeyColumns, LE>::DecodeKey(buf, std::get<I>(record)), ...);
+  }
+
+  template <typename Tuple, size_t... I>
+  static bool DecodeValueColumns(BufView& buf, Tuple& record, std::index_sequence<I...> /*columns*/) {
+    return (true && ... && StaticColumnCodec<ValueColumns, LE>::DecodeValue(buf, std::get<kKeyColumns + I>(record)));
+  }
+};
+
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,42 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/string_arena.h"
+
+#include <algorithm>
+
+namespace dingodb {
+
+StringArena::StringArena(int block_size) : block_size_(std::max(block_size, 1)) {}
+
+char* StringArena::Allocate(int size) {
+  if (blocks_.empty() || used_ + size > blocks_.back().capacity) {
+    // Oversized strings get a block of their own.
+    int capacity = std::max(size, block_size_);
+    blocks_.push_back({std::make_unique<char[]>(capacity), capacity});
+    used_ = 0;
+  }
+  char* data = blocks_.back().data.get() + used_;
+  used_ += size;
+  return data;
+}
+
+void StringArena::Reset() {
+  if (blocks_.size() > 1) {
+    blocks_.resize(1);
+  }
+  used_ = 0;
+}
+
+}  // namespace dingodb
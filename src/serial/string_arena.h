@@ -0,0 +1,48 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_STRING_ARENA_H_
+#define DINGO_SERIAL_STRING_ARENA_H_
+
+#include <memory>
+#include <vector>
+
+namespace dingodb {
+
+// Bump allocator for strings that cannot be viewed in place. Blocks never move, so a view into an earlier
+// allocation stays valid until Reset. Reset keeps the first block, an arena reused across a scan stops allocating.
+class StringArena {
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    int capacity;
+  };
+
+  std::vector<Block> blocks_;
+  int block_size_;
+  // Bytes handed out from the last block.
+  int used_ = 0;
+
+ public:
+  static constexpr int kDefaultBlockSize = 4096;
+
+  explicit StringArena(int block_size = kDefaultBlockSize);
+
+  char* Allocate(int size);
+  void Reset();
+};
+
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,168 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "serial/thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace dingodb {
+
+// Ranges handed out per thread, enough for stealing to even out rows of uneven width.
+static constexpr int kRangesPerThread = 4;
+
+struct ThreadPool::Job {
+  const std::function<void(int, int)>* fn;
+  std::atomic<int> pending;
+  // First exception thrown by fn, the ranges not started yet are skipped once it is set.
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable done_cv;
+};
+
+ThreadPool::ThreadPool(int num_threads) {
+  num_threads = std::max(num_threads, 1);
+  for (int i = 0; i < num_threads; i++) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back([this, i]() { WorkerLoop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stop_ = true;
+  }
+  wake_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+int ThreadPool::Size() const { return workers_.size(); }
+
+bool ThreadPool::Pop(int worker, Task& task) {
+  Queue& queue = *queues_[worker];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = queue.tasks.back();
+  queue.tasks.pop_back();
+  queued_--;
+  return true;
+}
+
+bool ThreadPool::Steal(int worker, Task& task) {
+  int size = queues_.size();
+  for (int i = 1; i <= size; i++) {
+    Queue& queue = *queues_[(worker + i) % size];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+      queued_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::Run(const Task& task) {
+  Job* job = task.job;
+  std::exception_ptr error;
+  if (!job->failed) {
+    try {
+      (*job->fn)(task.begin, task.end);
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  // Under the lock, the waiting ParallelFor cannot return and destroy the job before the notification is out.
+  std::lock_guard<std::mutex> lock(job->mutex);
+  if (error != nullptr && !job->failed) {
+    job->error = error;
+    job->failed = true;
+  }
+  if (--job->pending == 0) {
+    job->done_cv.notify_all();
+  }
+}
+
+void ThreadPool::WorkerLoop(int worker) {
+  Task task;
+  while (true) {
+    if (Pop(worker, task) || Steal(worker, task)) {
+      Run(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    wake_cv_.wait(lock, [this]() { return stop_ || queued_ > 0; });
+    if (stop_ && queued_ == 0) {
+      return;
+    }
+  }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int begin, int end)>& fn) {
+  if (count <= 0) {
+    return;
+  }
+  int ranges = std::min(count, (Size() + 1) * kRangesPerThread);
+  Job job;
+  job.fn = &fn;
+  job.pending = ranges;
+
+  // Consecutive ranges go to the same queue, so a worker that keeps to its own queue walks adjacent rows.
+  int size = queues_.size();
+  int first = next_queue_++ % size;
+  for (int i = 0; i < ranges; i++) {
+    Task task{&job, static_cast<int>(static_cast<int64_t>(count) * i / ranges),
+              static_cast<int>(static_cast<int64_t>(count) * (i + 1) / ranges)};
+    Queue& queue = *queues_[(first + i * size / ranges) % size];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(task);
+    queued_++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+  }
+  wake_cv_.notify_all();
+
+  // Help out instead of blocking, this also keeps nested calls from a worker making progress.
+  Task task;
+  while (job.pending > 0 && Steal(first, task)) {
+    Run(task);
+  }
+  std::unique_lock<std::mutex> lock(job.mutex);
+  job.done_cv.wait(lock, [&job]() { return job.pending == 0; });
+  if (job.error != nullptr) {
+    std::rethrow_exception(job.error);
+  }
+}
+
+void ParallelFor(ThreadPool* pool, int count, int min_count, const std::function<void(int begin, int end)>& fn) {
+  if (pool == nullptr || count < std::max(min_count, 2)) {
+    if (count > 0) {
+      fn(0, count);
+    }
+    return;
+  }
+  pool->ParallelFor(count, fn);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_THREAD_POOL_H_
+#define DINGO_SERIAL_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dingodb {
+
+// Work-stealing pool for the batch codecs. Every worker owns a queue, takes its own work from the back and steals
+// from the front of the others once it runs dry. One pool can be shared by any number of encoders and decoders.
+class ThreadPool {
+ private:
+  struct Job;
+
+  struct Task {
+    Job* job;
+    int begin;
+    int end;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool Pop(int worker, Task& task);
+  bool Steal(int worker, Task& task);
+  static void Run(const Task& task);
+  void WorkerLoop(int worker);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<int> queued_{0};
+  std::atomic<unsigned> next_queue_{0};
+  std::mutex wake_mutex_;
+  std::condition_variable wake_cv_;
+  bool stop_ = false;
+
+ public:
+  // num_threads workers, at least one.
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int Size() const;
+
+  // Split [0, count) into ranges, run fn(begin, end) on each and return once all have finished. The calling thread
+  // works on the ranges too, so calls may nest. When fn throws, the ranges not started yet are skipped and the first
+  // exception is rethrown here once no range is running, as the inline call would have thrown it.
+  void ParallelFor(int count, const std::function<void(int begin, int end)>& fn);
+};
+
+// fn(0, count) inline when pool is null or count is below min_count, pool->ParallelFor otherwise.
+void ParallelFor(ThreadPool* pool, int count, int min_count, const std::function<void(int begin, int end)>& fn);
+
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,187 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <serial/codec_handle.h>
+#include <serial/codec_registry.h>
+#include <serial/record_decoder.h>
+#include <serial/record_encoder.h>
+
+#include <any>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dingodb;
+using namespace std;
+
+class DingoCodecRegistryTest : public testing::Test {
+ public:
+  static shared_ptr<vector<shared_ptr<BaseSchema>>> CreateSchemas() {
+    auto schemas = make_shared<vector<shared_ptr<BaseSchema>>>(3);
+
+    auto id = make_shared<DingoSchema<optional<int64_t>>>();
+    id->SetIndex(0);
+    id->SetAllowNull(false);
+    id->SetIsKey(true);
+    schemas->at(0) = id;
+
+    auto name = make_shared<DingoSchema<optional<shared_ptr<string>>>>();
+    name->SetIndex(1);
+    name->SetAllowNull(true);
+    name->SetIsKey(false);
+    schemas->at(1) = name;
+
+    auto score = make_shared<DingoSchema<optional<double>>>();
+    score->SetIndex(2);
+    score->SetAllowNull(true);
+    score->SetIsKey(false);
+    schemas->at(2) = score;
+
+    return schemas;
+  }
+
+  static vector<any> CreateRecord(int64_t id) {
+    vector<any> record(3);
+    record[0] = optional<int64_t>(id);
+    record[1] = optional<shared_ptr<string>>(make_shared<string>("name"));
+    record[2] = optional<double>(id * 0.5);
+    return record;
+  }
+};
+
+TEST_F(DingoCodecRegistryTest, internsCodecs) {
+  auto schemas = CreateSchemas();
+  CodecRegistry registry(16, false);
+  EXPECT_EQ(nullptr, registry.Get(7, 1));
+
+  auto codec = registry.GetOrCreate(7, 1, schemas);
+  ASSERT_NE(nullptr, codec);
+  EXPECT_EQ(codec, registry.Get(7, 1));
+  EXPECT_EQ(codec, registry.GetOrCreate(7, 1, schemas));
+  EXPECT_NE(codec, registry.GetOrCreate(7, 2, schemas));
+  EXPECT_EQ(2, registry.Size());
+
+  // Same bytes as a codec built by hand.
+  RecordEncoder re(1, schemas, 7, false);
+  string key, value, expected_key, expected_value;
+  ASSERT_EQ(0, codec->encoder.Encode('r', CreateRecord(11), key, value));
+  ASSERT_EQ(0, re.Encode('r', CreateRecord(11), expected_key, expected_value));
+  EXPECT_EQ(expected_key, key);
+  EXPECT_EQ(expected_value, value);
+  vector<any> decoded;
+  ASSERT_EQ(0, codec->decoder.Decode(key, value, decoded));
+  EXPECT_EQ(11, any_cast<optional<int64_t>>(decoded[0]).value());
+
+  registry.Erase(7, 1);
+  EXPECT_EQ(nullptr, registry.Get(7, 1));
+  EXPECT_EQ(1, registry.Size());
+  // Erased codecs stay usable by their holders.
+  EXPECT_EQ(0, codec->encoder.Encode('r', CreateRecord(12), key, value));
+}
+
+TEST_F(DingoCodecRegistryTest, evictsColdTables) {
+  auto schemas = CreateSchemas();
+  CodecRegistry registry(8);
+  auto hot = registry.GetOrCreate(1, 1, schemas);
+  for (long common_id = 2; common_id < 100; common_id++) {
+    registry.GetOrCreate(common_id, 1, schemas);
+    EXPECT_LE(registry.Size(), registry.Capacity());
+    EXPECT_EQ(hot, registry.Get(1, 1));
+  }
+  EXPECT_EQ(8, registry.Size());
+  EXPECT_EQ(nullptr, registry.Get(2, 1));
+  EXPECT_NE(nullptr, registry.Get(99, 1));
+}
+
+TEST_F(DingoCodecRegistryTest, concurrentLookups) {
+  auto schemas = CreateSchemas();
+  CodecRegistry registry(32);
+  atomic<int> failures{0};
+  vector<thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 2000; i++) {
+        long common_id = (i * 7 + t) % 48;
+        auto codec = (i + t) % 3 == 0 ? registry.GetOrCreate(common_id, 1, schemas) : registry.Get(common_id, 1);
+        if (codec == nullptr) {
+          continue;
+        }
+        string key, value;
+        vector<any> decoded;
+        if (codec->common_id != common_id || codec->encoder.Encode('r', CreateRecord(i), key, value) != 0 ||
+            codec->decoder.Decode(key, value, decoded) != 0) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, failures);
+  EXPECT_LE(registry.Size(), registry.Capacity());
+}
+
+TEST_F(DingoCodecRegistryTest, hotSwapHandle) {
+  auto schemas = CreateSchemas();
+  CodecHandle handle(make_shared<const RecordCodec>(1, schemas, 7, true));
+  auto pinned = handle.Pin();
+  weak_ptr<const RecordCodec> retired = pinned;
+
+  // A scan keeps its codec across the swap, new pins see the next version.
+  string key, value;
+  ASSERT_EQ(0, pinned->encoder.Encode('r', CreateRecord(1), key, value));
+  EXPECT_TRUE(handle.Upgrade(make_shared<const RecordCodec>(2, schemas, 7, true)));
+  EXPECT_EQ(2, handle.SchemaVersion());
+  EXPECT_FALSE(handle.Upgrade(make_shared<const RecordCodec>(2, schemas, 7, true)));
+  EXPECT_EQ(1, pinned->schema_version);
+  vector<any> decoded;
+  EXPECT_EQ(0, pinned->decoder.Decode(key, value, decoded));
+  EXPECT_EQ(0, handle.Pin()->decoder.Decode(key, value, decoded));
+  EXPECT_FALSE(retired.expired());
+  pinned.reset();
+  EXPECT_TRUE(retired.expired());
+
+  // Readers pin and decode while the versions move on.
+  atomic<bool> stop{false};
+  atomic<int> failures{0};
+  vector<thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&]() {
+      int last_version = 0;
+      while (!stop) {
+        auto codec = handle.Pin();
+        vector<any> record;
+        if (codec->schema_version < last_version || codec->decoder.Decode(key, value, record) != 0) {
+          failures++;
+        }
+        last_version = codec->schema_version;
+      }
+    });
+  }
+  for (int version = 3; version < 200; version++) {
+    handle.Upgrade(make_shared<const RecordCodec>(version, schemas, 7, true));
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, failures);
+  EXPECT_EQ(199, handle.SchemaVersion());
+  EXPECT_EQ(1, handle.Swap(make_shared<const RecordCodec>(1, schemas, 7, true)).use_count());
+}
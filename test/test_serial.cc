@@ -1636,3 +1636,795 @@ TEST_F(DingoSerialTest, recordTest) {
   // delete kv;
   delete rd;
 }
+
+TEST_F(DingoSerialTest, recordDecodeFromView) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  InitRecord();
+
+  vector<any>* record1 = GetRecord();
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+
+  // Decode from views into a larger region, the way a storage slice is handed over.
+  std::string region = "##" + key + "##" + value + "##";
+  std::string_view key_view(region.data() + 2, key.size());
+  std::string_view value_view(region.data() + 4 + key.size(), value.size());
+
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  vector<any> record2;
+  ASSERT_EQ(0, rd.Decode(key_view, value_view, record2));
+  EXPECT_EQ(any_cast<optional<int32_t>>(record1->at(0)), any_cast<optional<int32_t>>(record2.at(0)));
+  EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>(record1->at(1)).value(),
+            *any_cast<optional<shared_ptr<string>>>(record2.at(1)).value());
+  EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>(record1->at(4)).value(),
+            *any_cast<optional<shared_ptr<string>>>(record2.at(4)).value());
+  EXPECT_FALSE(any_cast<optional<shared_ptr<string>>>(record2.at(6)).has_value());
+  EXPECT_EQ(any_cast<optional<int64_t>>(record1->at(9)), any_cast<optional<int64_t>>(record2.at(9)));
+  EXPECT_EQ(any_cast<optional<double>>(record1->at(10)), any_cast<optional<double>>(record2.at(10)));
+
+  BufView view(value_view, this->le);
+  EXPECT_EQ(0, view.ReadInt());
+  EXPECT_EQ(value.size() - 4, view.ReadString().size());
+  EXPECT_TRUE(view.IsEnd());
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, recordByteOrder) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  for (bool le : {true, false}) {
+    RecordEncoder re(0, schemas, 0L, le);
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+
+    RecordDecoder rd(0, schemas, 0L, le);
+    vector<any> record2;
+    ASSERT_EQ(0, rd.Decode(key, value, record2));
+    EXPECT_EQ(any_cast<optional<int32_t>>(record1->at(0)), any_cast<optional<int32_t>>(record2.at(0)));
+    EXPECT_EQ(any_cast<optional<int64_t>>(record1->at(9)), any_cast<optional<int64_t>>(record2.at(9)));
+    EXPECT_EQ(any_cast<optional<double>>(record1->at(10)), any_cast<optional<double>>(record2.at(10)));
+
+    // The compile time writers lay out bytes exactly like the runtime ones.
+    Buf runtime_buf(16, le);
+    runtime_buf.WriteInt(1543234);
+    runtime_buf.WriteLong(-8237583920453957801);
+    runtime_buf.ReverseWriteInt(1543234);
+    Buf fixed_buf(16, le);
+    if (le) {
+      fixed_buf.WriteInt<true>(1543234);
+      fixed_buf.WriteLong<true>(-8237583920453957801);
+      fixed_buf.ReverseWriteInt<true>(1543234);
+    } else {
+      fixed_buf.WriteInt<false>(1543234);
+      fixed_buf.WriteLong<false>(-8237583920453957801);
+      fixed_buf.ReverseWriteInt<false>(1543234);
+    }
+    std::string runtime_bytes, fixed_bytes;
+    runtime_buf.GetBytes(runtime_bytes);
+    fixed_buf.GetBytes(fixed_bytes);
+    EXPECT_EQ(runtime_bytes, fixed_bytes);
+
+    BufView view(fixed_bytes, le);
+    EXPECT_EQ(1543234, view.ReadInt());
+    EXPECT_EQ(-8237583920453957801, view.ReadLong());
+    EXPECT_EQ(1543234, view.ReverseReadInt());
+    EXPECT_TRUE(view.IsEnd());
+  }
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, recordEncodedSize) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+  EXPECT_EQ(key.size(), re.EncodedKeySize(*record1));
+  EXPECT_EQ(value.size(), re.EncodedValueSize(*record1));
+
+  // Large variable length columns are sized exactly as well, in the key and in the value.
+  record1->at(1) = optional<shared_ptr<string>>{std::make_shared<std::string>(50 * 1024 + 3, 'k')};
+  record1->at(4) = optional<shared_ptr<string>>{std::make_shared<std::string>(50 * 1024, 'v')};
+  record1->at(6) = optional<shared_ptr<string>>{std::make_shared<std::string>(7, 'p')};
+  record1->at(10) = optional<double>{};
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+  EXPECT_EQ(key.size(), re.EncodedKeySize(*record1));
+  EXPECT_EQ(value.size(), re.EncodedValueSize(*record1));
+
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  vector<any> record2;
+  ASSERT_EQ(0, rd.Decode(key, value, record2));
+  EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>(record1->at(1)).value(),
+            *any_cast<optional<shared_ptr<string>>>(record2.at(1)).value());
+  EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>(record1->at(4)).value(),
+            *any_cast<optional<shared_ptr<string>>>(record2.at(4)).value());
+  EXPECT_FALSE(any_cast<optional<double>>(record2.at(10)).has_value());
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, recordEncodeIntoSink) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+
+  // Append mode keeps what the string already holds.
+  std::string key_out = "head";
+  std::string value_out = "head";
+  StringSink key_sink(&key_out);
+  StringSink value_sink(&value_out);
+  ASSERT_EQ(0, re.Encode('r', *record1, key_sink, value_sink));
+  EXPECT_EQ("head" + key, key_out);
+  EXPECT_EQ("head" + value, value_out);
+
+  // Fixed region, key and value laid out back to back.
+  std::vector<char> region(key.size() + value.size());
+  FixedSink fixed_sink(region.data(), region.size());
+  EXPECT_EQ(key.size(), re.EncodeKey('r', *record1, fixed_sink));
+  EXPECT_EQ(value.size(), re.EncodeValue(*record1, fixed_sink));
+  EXPECT_EQ(region.size(), fixed_sink.Size());
+  EXPECT_EQ(key + value, std::string(region.data(), region.size()));
+
+  // A full region is rejected up front.
+  EXPECT_EQ(-1, re.EncodeKey('r', *record1, fixed_sink));
+
+  // Room for the key but not the value: the key sink gets its reservation back and holds nothing.
+  std::vector<char> key_region(key.size());
+  std::vector<char> value_region(value.size() - 1);
+  FixedSink key_only(key_region.data(), key_region.size());
+  FixedSink short_value(value_region.data(), value_region.size());
+  EXPECT_EQ(-1, re.Encode('r', *record1, key_only, short_value));
+  EXPECT_EQ(0, key_only.Size());
+  EXPECT_EQ(0, short_value.Size());
+  key_out = "head";
+  EXPECT_EQ(-1, re.Encode('r', *record1, key_sink, short_value));
+  EXPECT_EQ("head", key_out);
+
+  // Batch style target, records land one after another in a shared representation.
+  class BatchSink : public OutputSink {
+   public:
+    std::string rep;
+    char* Reserve(int size) override {
+      size_t offset = rep.size();
+      rep.resize(offset + size);
+      return rep.data() + offset;
+    }
+    void Unreserve(int size) override { rep.resize(rep.size() - size); }
+  };
+  BatchSink batch;
+  ASSERT_EQ(0, re.Encode('r', *record1, batch, batch));
+  ASSERT_EQ(0, re.Encode('r', *record1, batch, batch));
+  EXPECT_EQ(key + value + key + value, batch.rep);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, recordEncodeWithScratchBuffers) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder plain(0, schemas, 0L, this->le);
+  RecordEncoder reuse(0, schemas, 0L, this->le);
+  reuse.EnableScratchBuffers(256);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string expected, actual;
+  for (int round = 0; round < 3; round++) {
+    for (int column_count = 1; column_count <= 4; column_count++) {
+      ASSERT_LT(0, plain.EncodeKeyPrefix('r', *record1, column_count, expected));
+      ASSERT_LT(0, reuse.EncodeKeyPrefix('r', *record1, column_count, actual));
+      EXPECT_EQ(expected, actual);
+    }
+    // Grows the scratch buffer past the retain limit, the next call starts over.
+    record1->at(1) = optional<shared_ptr<string>>{std::make_shared<std::string>(1024 * (round + 1), 'n')};
+  }
+
+  std::vector<std::string> keys = {"1", "tn", "f"};
+  ASSERT_LT(0, plain.EncodeKeyPrefix('r', keys, expected));
+  ASSERT_LT(0, reuse.EncodeKeyPrefix('r', keys, actual));
+  EXPECT_EQ(expected, actual);
+
+  EXPECT_EQ(9, reuse.EncodeMinKeyPrefix('r', actual));
+  EXPECT_EQ(9, actual.size());
+  EXPECT_EQ(9, reuse.EncodeMaxKeyPrefix('r', actual));
+  EXPECT_EQ(9, actual.size());
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, recordKeyPrefixMatchesKey) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key;
+  ASSERT_LT(0, re.EncodeKey('r', *record1, key));
+
+  // Every column prefix of the key is laid out exactly like the key itself, minus the tail.
+  std::string prefix;
+  size_t last_size = 0;
+  for (int column_count = 0; column_count <= 4; column_count++) {
+    ASSERT_LT(0, re.EncodeKeyPrefix('r', *record1, column_count, prefix));
+    EXPECT_EQ(key.substr(0, prefix.size()), prefix);
+    EXPECT_LE(last_size, prefix.size());
+    last_size = prefix.size();
+  }
+  EXPECT_LT(9, last_size);
+
+  std::string prefix_from_keys;
+  ASSERT_LT(0, re.EncodeKeyPrefix('r', std::vector<std::string>{"0", "tn", "f"}, prefix_from_keys));
+  ASSERT_LT(0, re.EncodeKeyPrefix('r', *record1, 3, prefix));
+  EXPECT_EQ(prefix, prefix_from_keys);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, recordDecodeWithProjection) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::vector<int> column_indexes = {9, 1, 4, 0};
+  Projection projection = rd.CreateProjection(column_indexes);
+  for (int row = 0; row < 5; row++) {
+    record1->at(0) = optional<int32_t>(row);
+    record1->at(9) = optional<int64_t>(-row * 1000L);
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+
+    vector<any> expected, actual;
+    ASSERT_EQ(0, rd.Decode(key, value, column_indexes, expected));
+    ASSERT_EQ(0, rd.Decode(key, value, projection, actual));
+    ASSERT_EQ(4, actual.size());
+    EXPECT_EQ(any_cast<optional<int64_t>>(expected.at(0)), any_cast<optional<int64_t>>(actual.at(0)));
+    EXPECT_EQ(-row * 1000L, any_cast<optional<int64_t>>(actual.at(0)).value());
+    EXPECT_EQ("tn", *any_cast<optional<shared_ptr<string>>>(actual.at(1)).value());
+    EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>(record1->at(4)).value(),
+              *any_cast<optional<shared_ptr<string>>>(actual.at(2)).value());
+    EXPECT_EQ(row, any_cast<optional<int32_t>>(actual.at(3)).value());
+  }
+
+  // Projections of a wider schema do not apply.
+  std::vector<int> too_wide(20);
+  for (int i = 0; i < 20; i++) {
+    too_wide[i] = i;
+  }
+  auto small_schemas = std::make_shared<vector<std::shared_ptr<BaseSchema>>>(schemas->begin(), schemas->begin() + 4);
+  RecordDecoder small_rd(0, small_schemas, 0L, this->le);
+  Projection wide = rd.CreateProjection(too_wide);
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+  vector<any> out;
+  EXPECT_EQ(-1, small_rd.Decode(key, value, wide, out));
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, recordDecodeSeekFixedValues) {
+  // id key, then 40 fixed width value columns of mixed nullability, then two strings.
+  auto schemas = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  auto id = std::make_shared<DingoSchema<optional<int32_t>>>();
+  id->SetIndex(0);
+  id->SetIsKey(true);
+  id->SetAllowNull(false);
+  schemas->push_back(id);
+  for (int i = 1; i <= 40; i++) {
+    if (i % 3 == 0) {
+      auto col = std::make_shared<DingoSchema<optional<double>>>();
+      col->SetIndex(i);
+      col->SetIsKey(false);
+      col->SetAllowNull(i % 2 == 0);
+      schemas->push_back(col);
+    } else {
+      auto col = std::make_shared<DingoSchema<optional<int64_t>>>();
+      col->SetIndex(i);
+      col->SetIsKey(false);
+      col->SetAllowNull(i % 2 == 0);
+      schemas->push_back(col);
+    }
+  }
+  for (int i = 41; i <= 42; i++) {
+    auto col = std::make_shared<DingoSchema<optional<shared_ptr<string>>>>();
+    col->SetIndex(i);
+    col->SetIsKey(false);
+    col->SetAllowNull(true);
+    schemas->push_back(col);
+  }
+
+  vector<any> record(43);
+  record[0] = optional<int32_t>(7);
+  for (int i = 1; i <= 40; i++) {
+    if (i % 3 == 0) {
+      record[i] = i % 4 == 0 ? optional<double>() : optional<double>(i * 1.5);
+    } else {
+      record[i] = i % 4 == 0 ? optional<int64_t>() : optional<int64_t>(i * 100);
+    }
+  }
+  record[41] = optional<shared_ptr<string>>(std::make_shared<string>("first"));
+  record[42] = optional<shared_ptr<string>>(std::make_shared<string>("second"));
+
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+
+  vector<any> out;
+  ASSERT_EQ(0, rd.Decode(key, value, rd.CreateProjection({38, 42, 39, 8}), out));
+  EXPECT_EQ(3800, any_cast<optional<int64_t>>(out.at(0)).value());
+  EXPECT_EQ("second", *any_cast<optional<shared_ptr<string>>>(out.at(1)).value());
+  EXPECT_EQ(39 * 1.5, any_cast<optional<double>>(out.at(2)).value());
+  EXPECT_FALSE(any_cast<optional<int64_t>>(out.at(3)).has_value());
+
+  ASSERT_EQ(0, rd.Decode(key, value, rd.CreateProjection({41, 0}), out));
+  EXPECT_EQ("first", *any_cast<optional<shared_ptr<string>>>(out.at(0)).value());
+  EXPECT_EQ(7, any_cast<optional<int32_t>>(out.at(1)).value());
+
+  // A value written by a narrower schema, the columns past its end read as null.
+  auto narrow = std::make_shared<vector<std::shared_ptr<BaseSchema>>>(schemas->begin(), schemas->begin() + 11);
+  RecordEncoder narrow_re(0, narrow, 0L, this->le);
+  std::string narrow_value;
+  ASSERT_LT(0, narrow_re.EncodeValue(record, narrow_value));
+  ASSERT_EQ(0, rd.Decode(key, narrow_value, rd.CreateProjection({10, 21, 41}), out));
+  EXPECT_EQ(1000, any_cast<optional<int64_t>>(out.at(0)).value());
+  EXPECT_FALSE(any_cast<optional<double>>(out.at(1)).has_value());
+  EXPECT_FALSE(any_cast<optional<shared_ptr<string>>>(out.at(2)).has_value());
+
+  // Columnar, the fixed width columns a column at a time.
+  EncodedBatch batch;
+  for (const auto& row_value : {value, narrow_value, value}) {
+    batch.keys += key;
+    batch.values += row_value;
+    batch.key_offsets.push_back(batch.keys.size() - key.size());
+    batch.value_offsets.push_back(batch.values.size() - row_value.size());
+  }
+  batch.key_offsets.push_back(batch.keys.size());
+  batch.value_offsets.push_back(batch.values.size());
+  ColumnBatch columns;
+  ASSERT_EQ(3, rd.DecodeBatch(batch, rd.CreateProjection({38, 42, 39, 8, 0}), columns));
+  EXPECT_EQ(3800, columns.columns[0].Get<int64_t>(2));
+  EXPECT_TRUE(columns.columns[0].IsNull(1));
+  EXPECT_EQ("second", columns.columns[1].GetString(0));
+  EXPECT_TRUE(columns.columns[1].IsNull(1));
+  EXPECT_EQ(39 * 1.5, columns.columns[2].Get<double>(0));
+  EXPECT_EQ(3, columns.columns[3].null_count);
+  EXPECT_EQ(7, columns.columns[4].Get<int32_t>(1));
+}
+
+TEST_F(DingoSerialTest, recordDecodeKeyOnlyProjection) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+
+  Projection covered = rd.CreateProjection({3, 1});
+  EXPECT_TRUE(covered.IsKeyOnly());
+  EXPECT_FALSE(rd.CreateProjection({3, 4}).IsKeyOnly());
+
+  vector<any> out;
+  ASSERT_EQ(0, rd.DecodeKey(key, covered, out));
+  ASSERT_EQ(2, out.size());
+  EXPECT_EQ(214748364700L, any_cast<optional<int64_t>>(out.at(0)).value());
+  EXPECT_EQ("tn", *any_cast<optional<shared_ptr<string>>>(out.at(1)).value());
+
+  // The value is never looked at, not even its schema version.
+  ASSERT_EQ(0, rd.Decode(key, std::string_view(), covered, out));
+  EXPECT_EQ(214748364700L, any_cast<optional<int64_t>>(out.at(0)).value());
+
+  EXPECT_EQ(-1, rd.DecodeKey(key, rd.CreateProjection({3, 4}), out));
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+template <typename T>
+static std::shared_ptr<BaseSchema> VersionSchema(int index, bool key) {
+  auto schema = std::make_shared<DingoSchema<optional<T>>>();
+  schema->SetIndex(index);
+  schema->SetAllowNull(!key);
+  schema->SetIsKey(key);
+  return schema;
+}
+
+TEST_F(DingoSerialTest, recordDecodeOlderSchemaVersions) {
+  // Version 1: id | score, legacy, age.
+  auto v1 = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  v1->push_back(VersionSchema<int64_t>(0, true));
+  v1->push_back(VersionSchema<double>(1, false));
+  v1->push_back(VersionSchema<int64_t>(2, false));
+  v1->push_back(VersionSchema<int32_t>(3, false));
+  // Version 2 dropped legacy, moved age before score and added a name.
+  auto v2 = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  v2->push_back(VersionSchema<int64_t>(0, true));
+  v2->push_back(VersionSchema<int32_t>(1, false));
+  v2->push_back(VersionSchema<shared_ptr<string>>(2, false));
+  v2->push_back(VersionSchema<double>(3, false));
+  // Version 1 as seen from version 2.
+  auto v1_in_v2 = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  v1_in_v2->push_back(VersionSchema<int64_t>(0, true));
+  v1_in_v2->push_back(VersionSchema<double>(3, false));
+  v1_in_v2->push_back(VersionSchema<int64_t>(-1, false));
+  v1_in_v2->push_back(VersionSchema<int32_t>(1, false));
+
+  RecordEncoder re1(1, v1, 9L, this->le);
+  vector<any> old_record{optional<int64_t>(42), optional<double>(2.5), optional<int64_t>(7), optional<int32_t>(30)};
+  string key, value;
+  ASSERT_EQ(0, re1.Encode('r', old_record, key, value));
+
+  RecordDecoder rd(2, v2, 9L, this->le);
+  vector<any> out;
+  EXPECT_EQ(-1, rd.AddSchemaVersion(2, v1_in_v2));
+  ASSERT_EQ(0, rd.AddSchemaVersion(1, v1_in_v2));
+  ASSERT_EQ(0, rd.Decode(key, value, out));
+  EXPECT_EQ(42, any_cast<optional<int64_t>>(out[0]).value());
+  EXPECT_EQ(30, any_cast<optional<int32_t>>(out[1]).value());
+  EXPECT_FALSE(any_cast<optional<shared_ptr<string>>>(out[2]).has_value());
+  EXPECT_EQ(2.5, any_cast<optional<double>>(out[3]).value());
+
+  ASSERT_EQ(0, rd.SetColumnDefault(2, optional<shared_ptr<string>>(make_shared<string>("unknown"))));
+  EXPECT_EQ(-1, rd.SetColumnDefault(0, optional<int64_t>(0)));
+  Row row;
+  ASSERT_EQ(0, rd.Decode(key, value, row));
+  EXPECT_EQ(30, row.GetInt(1));
+  EXPECT_EQ("unknown", row.GetString(2));
+  EXPECT_EQ(2.5, row.GetDouble(3));
+  LazyRecord lazy;
+  ASSERT_EQ(0, rd.Decode(key, value, lazy));
+  EXPECT_EQ(2.5, any_cast<optional<double>>(lazy.Get(3)).value());
+  EXPECT_EQ("unknown", *any_cast<optional<shared_ptr<string>>>(lazy.Get(2)).value());
+  EXPECT_EQ(30, any_cast<optional<int32_t>>(lazy.Get(1)).value());
+
+  ASSERT_EQ(0, rd.Decode(key, value, rd.CreateProjection({3, 2, 0}), out));
+  ASSERT_EQ(3, out.size());
+  EXPECT_EQ(2.5, any_cast<optional<double>>(out[0]).value());
+  EXPECT_EQ("unknown", *any_cast<optional<shared_ptr<string>>>(out[1]).value());
+  EXPECT_EQ(42, any_cast<optional<int64_t>>(out[2]).value());
+  Filter filter;
+  auto unknown = optional<shared_ptr<string>>(make_shared<string>("unknown"));
+  ASSERT_EQ(0, rd.CreateFilter({{3, Predicate::kGreater, optional<double>(2.0), any()},
+                                {2, Predicate::kEqual, unknown, any()},
+                                {1, Predicate::kEqual, optional<int32_t>(30), any()}},
+                               filter));
+  EXPECT_EQ(1, rd.Match(key, value, filter));
+
+  // Current values keep the current layout.
+  RecordEncoder re2(2, v2, 9L, this->le);
+  vector<any> record{optional<int64_t>(43), optional<int32_t>(31),
+                     optional<shared_ptr<string>>(make_shared<string>("n")), optional<double>(1.5)};
+  ASSERT_EQ(0, re2.Encode('r', record, key, value));
+  ASSERT_EQ(0, rd.Decode(key, value, row));
+  EXPECT_EQ(31, row.GetInt(1));
+  EXPECT_EQ("n", row.GetString(2));
+  EXPECT_EQ(1.5, row.GetDouble(3));
+}
+
+TEST_F(DingoSerialTest, recordDecodeStringViews) {
+  auto schemas = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  schemas->push_back(VersionSchema<shared_ptr<string>>(0, true));
+  schemas->push_back(VersionSchema<shared_ptr<string>>(1, true));
+  schemas->push_back(VersionSchema<int64_t>(2, false));
+  schemas->push_back(VersionSchema<shared_ptr<string>>(3, false));
+  schemas->push_back(VersionSchema<shared_ptr<string>>(4, false));
+  RecordEncoder re(1, schemas, 5L, this->le);
+  RecordDecoder rd(1, schemas, 5L, this->le);
+  vector<any> record{optional<shared_ptr<string>>(make_shared<string>("12345678")),
+                     optional<shared_ptr<string>>(make_shared<string>("a key of several groups")), optional<int64_t>(7),
+                     optional<shared_ptr<string>>(make_shared<string>("value")), optional<shared_ptr<string>>()};
+  string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+
+  LazyRecord lazy;
+  ASSERT_EQ(0, rd.Decode(key, value, lazy));
+  optional<std::string_view> view;
+  ASSERT_EQ(0, lazy.GetString(4, view));
+  EXPECT_FALSE(view.has_value());
+  ASSERT_EQ(0, lazy.GetString(3, view));
+  EXPECT_EQ("value", view.value());
+  EXPECT_TRUE(view->data() >= value.data() && view->data() < value.data() + value.size());
+  ASSERT_EQ(0, lazy.GetString(1, view));
+  EXPECT_EQ("a key of several groups", view.value());
+  ASSERT_EQ(0, lazy.GetString(0, view));
+  EXPECT_EQ("12345678", view.value());
+  EXPECT_TRUE(view->data() >= key.data() && view->data() < key.data() + key.size());
+  EXPECT_EQ(-1, lazy.GetString(2, view));
+  EXPECT_FALSE(lazy.IsDecoded(1));
+
+  // Mixed with decoded columns.
+  EXPECT_EQ(7, any_cast<optional<int64_t>>(lazy.Get(2)).value());
+  EXPECT_EQ("value", *any_cast<optional<shared_ptr<string>>>(lazy.Get(3)).value());
+  ASSERT_EQ(0, lazy.GetString(3, view));
+  EXPECT_EQ("value", view.value());
+}
+
+TEST_F(DingoSerialTest, recordFilterOnEncodedBytes) {
+  auto schemas = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  schemas->push_back(VersionSchema<int64_t>(0, true));
+  schemas->push_back(VersionSchema<shared_ptr<string>>(1, true));
+  schemas->push_back(VersionSchema<int32_t>(2, false));
+  schemas->push_back(VersionSchema<double>(3, false));
+  schemas->push_back(VersionSchema<shared_ptr<string>>(4, false));
+  auto name = [](int i) { return make_shared<string>(string(i % 5 * 4, 'a' + i % 3)); };
+  auto record = [&name](int i) {
+    return vector<any>{optional<int64_t>(i - 50), optional<shared_ptr<string>>(name(i)),
+                       i % 7 == 0 ? optional<int32_t>() : optional<int32_t>(i % 10), optional<double>(i * -0.5),
+                       i % 2 == 0 ? optional<shared_ptr<string>>(make_shared<string>("even"))
+                                  : optional<shared_ptr<string>>()};
+  };
+
+  // Both byte orders, little endian keys are compared as values.
+  for (bool le : {true, false}) {
+    RecordEncoder re(1, schemas, 3L, le);
+    RecordDecoder rd(1, schemas, 3L, le);
+    Filter filter;
+    EXPECT_EQ(-1, rd.CreateFilter({{5, Predicate::kIsNull, any(), any()}}, filter));
+    EXPECT_EQ(-1, rd.CreateFilter({{2, Predicate::kEqual, optional<int64_t>(1), any()}}, filter));
+    auto bbb = optional<shared_ptr<string>>(make_shared<string>("bbb"));
+    auto even = optional<shared_ptr<string>>(make_shared<string>("even"));
+    ASSERT_EQ(0, rd.CreateFilter({{0, Predicate::kBetween, optional<int64_t>(-20), optional<int64_t>(30)},
+                                  {1, Predicate::kGreaterEqual, bbb, any()},
+                                  {2, Predicate::kLess, optional<int32_t>(6), any()},
+                                  {2, Predicate::kIsNotNull, any(), any()},
+                                  {3, Predicate::kLessEqual, optional<double>(-5.0), any()},
+                                  {4, Predicate::kEqual, even, any()}},
+                                 filter));
+    int matches = 0;
+    for (int i = 0; i < 100; i++) {
+      string key, value;
+      ASSERT_EQ(0, re.Encode('r', record(i), key, value));
+      bool expected = i - 50 >= -20 && i - 50 <= 30 && *name(i) >= "bbb" && i % 7 != 0 && i % 10 < 6 &&
+                      i * -0.5 <= -5.0 && i % 2 == 0;
+      ASSERT_EQ(expected ? 1 : 0, rd.Match(key, value, filter)) << i;
+      matches += expected;
+    }
+    EXPECT_LT(0, matches);
+
+    string key, value;
+    ASSERT_EQ(0, re.Encode('r', record(7), key, value));
+    ASSERT_EQ(0, rd.CreateFilter({{2, Predicate::kIsNull, any(), any()}, {4, Predicate::kIsNull, any(), any()}},
+                                 filter));
+    EXPECT_EQ(1, rd.Match(key, value, filter));
+    ASSERT_EQ(0, rd.CreateFilter({{4, Predicate::kLess, optional<shared_ptr<string>>(), any()}}, filter));
+    EXPECT_EQ(0, rd.Match(key, value, filter));
+    RecordDecoder other_table(1, schemas, 4L, le);
+    EXPECT_EQ(-1, other_table.Match(key, value, filter));
+  }
+}
+
+TEST_F(DingoSerialTest, recordFilterOnNarrowerValue) {
+  auto narrow = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  narrow->push_back(VersionSchema<int64_t>(0, true));
+  narrow->push_back(VersionSchema<double>(1, false));
+  auto wide = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  wide->push_back(VersionSchema<int64_t>(0, true));
+  wide->push_back(VersionSchema<double>(1, false));
+  wide->push_back(VersionSchema<int32_t>(2, false));
+  wide->push_back(VersionSchema<int64_t>(3, false));
+  RecordEncoder re(1, narrow, 5L, this->le);
+  string key, value;
+  ASSERT_EQ(0, re.Encode('r', vector<any>{optional<int64_t>(1), optional<double>(0.5)}, key, value));
+
+  // Without a registered layout for version 1 the value is read with the current one, and the columns added since
+  // lie past its end: they match and decode as null.
+  RecordDecoder rd(2, wide, 5L, this->le);
+  Filter filter;
+  ASSERT_EQ(0, rd.CreateFilter({{3, Predicate::kIsNull, any(), any()},
+                                {1, Predicate::kEqual, optional<double>(0.5), any()}},
+                               filter));
+  EXPECT_EQ(1, rd.Match(key, value, filter));
+  ASSERT_EQ(0, rd.CreateFilter({{3, Predicate::kEqual, optional<int64_t>(0), any()}}, filter));
+  EXPECT_EQ(0, rd.Match(key, value, filter));
+  ASSERT_EQ(0, rd.CreateFilter({{2, Predicate::kGreaterEqual, optional<int32_t>(0), any()}}, filter));
+  EXPECT_EQ(0, rd.Match(key, value, filter));
+  vector<any> out;
+  ASSERT_EQ(0, rd.Decode(key, value, rd.CreateProjection({3}), out));
+  EXPECT_FALSE(any_cast<optional<int64_t>>(out[0]).has_value());
+}
+
+TEST_F(DingoSerialTest, recordDecodeTruncated) {
+  auto schemas = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  schemas->push_back(VersionSchema<int64_t>(0, true));
+  schemas->push_back(VersionSchema<int32_t>(1, false));
+  RecordEncoder re(1, schemas, 3L);
+  RecordDecoder rd(1, schemas, 3L);
+  string key, value;
+  ASSERT_EQ(0, re.Encode('r', vector<any>{optional<int64_t>(7), optional<int32_t>(8)}, key, value));
+  Filter filter;
+  ASSERT_EQ(0, rd.CreateFilter({{1, Predicate::kIsNotNull, any(), any()}}, filter));
+  Projection projection = rd.CreateProjection({1, 0});
+
+  // A key shorter than its prefix and tag, or a value shorter than its schema version, is refused.
+  for (const auto& [k, v] : vector<pair<string, string>>{
+           {"", value}, {key.substr(0, 12), value}, {key, ""}, {key, value.substr(0, 3)}}) {
+    vector<any> record;
+    Row row;
+    LazyRecord lazy;
+    EXPECT_EQ(-1, rd.Decode(k, v, record));
+    EXPECT_EQ(-1, rd.Decode(k, v, row));
+    EXPECT_EQ(-1, rd.Decode(k, v, projection, record));
+    EXPECT_EQ(-1, rd.Decode(k, v, lazy));
+    EXPECT_EQ(-1, rd.Match(k, v, filter));
+    if (k.size() < key.size()) {
+      EXPECT_EQ(-1, rd.DecodeKey(k, record));
+    }
+  }
+  vector<any> record;
+  EXPECT_EQ(0, rd.Decode(key, value, record));
+}
+
+TEST_F(DingoSerialTest, recordDecodeCorruptLength) {
+  auto schemas = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+  schemas->push_back(VersionSchema<int64_t>(0, true));
+  schemas->push_back(VersionSchema<shared_ptr<string>>(1, true));
+  schemas->push_back(VersionSchema<shared_ptr<string>>(2, false));
+  schemas->push_back(VersionSchema<shared_ptr<vector<int32_t>>>(3, false));
+  schemas->push_back(VersionSchema<shared_ptr<vector<string>>>(4, false));
+  RecordEncoder re(1, schemas, 3L, this->le);
+  RecordDecoder rd(1, schemas, 3L, this->le);
+  string key, value;
+  ASSERT_EQ(0, re.Encode('r',
+                         vector<any>{optional<int64_t>(7), optional<shared_ptr<string>>(make_shared<string>("key")),
+                                     optional<shared_ptr<string>>(make_shared<string>("value")),
+                                     optional<shared_ptr<vector<int32_t>>>(make_shared<vector<int32_t>>(3, 1)),
+                                     optional<shared_ptr<vector<string>>>(
+                                         make_shared<vector<string>>(vector<string>{"a", "bc"}))},
+                         key, value));
+  Projection projection = rd.CreateProjection({2, 3, 4, 0});
+  Filter filter;
+  ASSERT_EQ(0, rd.CreateFilter({{2, Predicate::kIsNotNull, any(), any()}}, filter));
+
+  // |schema version|tag|string length|value|tag|list length|ints|tag|list length|string length|a|...
+  const int string_length = 5;
+  const int list_length = string_length + 4 + 5 + 1;
+  const int strings_length = list_length + 4 + 12 + 1;
+  for (int offset : {string_length, list_length, strings_length, strings_length + 4}) {
+    for (const string& length : {string(4, '\x7f'), string(4, '\xff')}) {
+      string corrupt = value;
+      corrupt.replace(offset, 4, length);
+      vector<any> record;
+      Row row;
+      EXPECT_EQ(-1, rd.Decode(key, corrupt, record));
+      EXPECT_EQ(-1, rd.Decode(key, corrupt, row));
+      EXPECT_EQ(-1, rd.Decode(key, corrupt, projection, record));
+      EXPECT_EQ(-1, rd.Decode(key, corrupt, projection, row));
+    }
+  }
+  string corrupt = value;
+  corrupt.replace(string_length, 4, string(4, '\x7f'));
+  LazyRecord lazy;
+  ASSERT_EQ(0, rd.Decode(key, corrupt, lazy));
+  std::optional<std::string_view> view;
+  EXPECT_EQ(-1, lazy.GetString(2, view));
+  EXPECT_TRUE(lazy.IsCorrupt());
+  EXPECT_EQ(-1, rd.Match(key, corrupt, filter));
+
+  // A value cut inside its string.
+  vector<any> record;
+  EXPECT_EQ(-1, rd.Decode(key, value.substr(0, string_length + 6), record));
+
+  // The length of the key string, read from the tail, claims more than the key holds.
+  for (const string& length : {string(4, '\x7f'), string(4, '\xff'), string(4, '\0')}) {
+    string corrupt_key = key;
+    corrupt_key.replace(key.size() - 8, 4, length);
+    Row row;
+    EXPECT_EQ(-1, rd.Decode(corrupt_key, value, record));
+    EXPECT_EQ(-1, rd.Decode(corrupt_key, value, row));
+    EXPECT_EQ(-1, rd.DecodeKey(corrupt_key, record));
+  }
+
+  EXPECT_EQ(0, rd.Decode(key, value, record));
+  EXPECT_EQ(1, rd.Match(key, value, filter));
+}
+
+TEST_F(DingoSerialTest, recordDecodeBatchSortedSchemas) {
+  // A string value column before an int, SortSchema moves it behind the fixed width ones. The second round leaves a
+  // null entry in the schemas, which the decode program skips.
+  for (bool with_null : {false, true}) {
+    auto schemas = std::make_shared<vector<std::shared_ptr<BaseSchema>>>();
+    schemas->push_back(VersionSchema<int64_t>(0, true));
+    schemas->push_back(VersionSchema<shared_ptr<string>>(1, false));
+    schemas->push_back(VersionSchema<int32_t>(2, false));
+    if (with_null) {
+      schemas->push_back(nullptr);
+    }
+    schemas->push_back(VersionSchema<double>(4, false));
+    SortSchema(schemas);
+    ASSERT_EQ(BaseSchema::kString, schemas->back()->GetType());
+
+    RecordEncoder re(1, schemas, 2L, this->le);
+    RecordDecoder rd(1, schemas, 2L, this->le);
+    std::vector<std::vector<std::any>> records;
+    for (int i = 0; i < 6; i++) {
+      records.push_back({optional<int64_t>(i), optional<shared_ptr<string>>(make_shared<string>(string(i, 's'))),
+                         i % 2 == 0 ? optional<int32_t>() : optional<int32_t>(i * 10), std::any(),
+                         optional<double>(i * 0.25)});
+    }
+    EncodedBatch batch;
+    ASSERT_EQ(6, re.EncodeBatch('r', records, batch));
+
+    // Every program ordinal, in an order unlike the schemas.
+    Projection projection = rd.CreateProjection({3, 2, 0, 1});
+    ColumnBatch columns;
+    ASSERT_EQ(6, rd.DecodeBatch(batch, projection, columns));
+    ASSERT_EQ(4, columns.columns.size());
+    for (int i = 0; i < 6; i++) {
+      Row row;
+      ASSERT_EQ(0, rd.Decode(batch.Key(i), batch.Value(i), projection, row));
+      for (int c = 0; c < 4; c++) {
+        const ColumnVector& column = columns.columns[c];
+        ASSERT_EQ(row.IsNull(c), column.IsNull(i)) << with_null << " " << i << " " << c;
+        if (row.IsNull(c)) {
+          continue;
+        }
+        ASSERT_EQ(row.GetType(c), column.type);
+        switch (column.type) {
+          case BaseSchema::kInteger:
+            EXPECT_EQ(row.GetInt(c), column.Get<int32_t>(i));
+            break;
+          case BaseSchema::kLong:
+            EXPECT_EQ(row.GetLong(c), column.Get<int64_t>(i));
+            break;
+          case BaseSchema::kDouble:
+            EXPECT_EQ(row.GetDouble(c), column.Get<double>(i));
+            break;
+          default:
+            EXPECT_EQ(row.GetString(c), column.GetString(i));
+            break;
+        }
+      }
+    }
+    EXPECT_EQ(BaseSchema::kString, columns.columns[0].type);
+    EXPECT_EQ(BaseSchema::kInteger, columns.columns[1].type);
+    EXPECT_EQ(3, columns.columns[1].null_count);
+
+    // Arrow fields carry the names of their own schemas, the unnamed int its record index.
+    for (const auto& schema : *schemas) {
+      if (schema != nullptr && schema->GetIndex() != 2) {
+        schema->SetName("column" + std::to_string(schema->GetIndex()));
+      }
+    }
+    ArrowSchema arrow_schema;
+    ArrowArray arrow_array;
+    ASSERT_EQ(0, rd.DecodeArrow(batch, projection, &arrow_schema, &arrow_array));
+    ASSERT_EQ(4, arrow_schema.n_children);
+    EXPECT_STREQ("column1", arrow_schema.children[0]->name);
+    EXPECT_STREQ("u", arrow_schema.children[0]->format);
+    EXPECT_STREQ("2", arrow_schema.children[1]->name);
+    EXPECT_STREQ("i", arrow_schema.children[1]->format);
+    EXPECT_STREQ("column0", arrow_schema.children[2]->name);
+    EXPECT_STREQ("column4", arrow_schema.children[3]->name);
+    EXPECT_STREQ("g", arrow_schema.children[3]->format);
+    arrow_array.release(&arrow_array);
+    arrow_schema.release(&arrow_schema);
+  }
+}
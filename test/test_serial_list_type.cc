@@ -19,10 +19,12 @@
 #include <serial/utils.h>
 
 #include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 
 // #include "serial/keyvalue_codec.h"
 #include "serial/schema/base_schema.h"
@@ -1612,6 +1614,8 @@ TEST_F(DingoSerialListTypeTest, recordTest) {
   std::cout << "schemas size:" << schemas->size() << '\n';
   std::string key, value;
   (void)re->Encode('r', *record1, key, value);
+  EXPECT_EQ(key.size(), re->EncodedKeySize(*record1));
+  EXPECT_EQ(value.size(), re->EncodedValueSize(*record1));
   delete re;
 
   RecordDecoder* rd = new RecordDecoder(0, schemas, 0L, this->le);
@@ -2031,3 +2035,500 @@ TEST_F(DingoSerialListTypeTest, recordTest) {
   // delete kv;
   delete rd;
 }
+
+TEST_F(DingoSerialListTypeTest, recordRowRoundTrip) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+
+  Row row(25);
+  row.SetInt(0, 0);
+  row.SetString(1, "tn");
+  row.SetString(2, "f");
+  row.SetLong(3, 214748364700L);
+  row.SetString(4, *any_cast<optional<shared_ptr<string>>>(record1->at(4)).value());
+  row.SetBool(5, false);
+  row.SetInt(8, -20);
+  row.SetLong(9, -214748364700L);
+  row.SetDouble(10, 873485.4234);
+  for (int i = 11; i <= 24; i++) {
+    switch (schemas->at(i)->GetType()) {
+      case BaseSchema::kBoolList:
+        row.SetList(i, *any_cast<optional<shared_ptr<vector<bool>>>>(record1->at(i)).value());
+        break;
+      case BaseSchema::kIntegerList:
+        row.SetList(i, *any_cast<optional<shared_ptr<vector<int32_t>>>>(record1->at(i)).value());
+        break;
+      case BaseSchema::kFloatList:
+        row.SetList(i, *any_cast<optional<shared_ptr<vector<float>>>>(record1->at(i)).value());
+        break;
+      case BaseSchema::kLongList:
+        row.SetList(i, *any_cast<optional<shared_ptr<vector<int64_t>>>>(record1->at(i)).value());
+        break;
+      case BaseSchema::kDoubleList:
+        row.SetList(i, *any_cast<optional<shared_ptr<vector<double>>>>(record1->at(i)).value());
+        break;
+      default:
+        row.SetStringList(i, *any_cast<optional<shared_ptr<vector<string>>>>(record1->at(i)).value());
+        break;
+    }
+  }
+
+  // Byte-identical to the std::any record.
+  std::string row_key, row_value;
+  ASSERT_EQ(0, re.Encode('r', row, row_key, row_value));
+  EXPECT_EQ(key, row_key);
+  EXPECT_EQ(value, row_value);
+  EXPECT_EQ(key.size(), re.EncodedKeySize(row));
+  EXPECT_EQ(value.size(), re.EncodedValueSize(row));
+
+  Row decoded;
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  ASSERT_EQ(25, decoded.Size());
+  EXPECT_EQ("tn", decoded.GetString(1));
+  EXPECT_EQ(214748364700L, decoded.GetLong(3));
+  EXPECT_TRUE(decoded.IsNull(6));
+  EXPECT_TRUE(decoded.IsNull(7));
+  EXPECT_EQ(873485.4234, decoded.GetDouble(10));
+  EXPECT_EQ(5, decoded.GetListSize(12));
+  EXPECT_TRUE(decoded.GetListElement<bool>(12, 4));
+  EXPECT_EQ("中文", decoded.GetStringListElement(14, 1));
+  EXPECT_EQ(2469999883732L, decoded.GetListElement<int64_t>(22, 3));
+
+  std::string decoded_key, decoded_value;
+  ASSERT_EQ(0, re.Encode('r', decoded, decoded_key, decoded_value));
+  EXPECT_EQ(key, decoded_key);
+  EXPECT_EQ(value, decoded_value);
+
+  // A cell of the wrong type fails the encode.
+  row.SetLong(8, -20);
+  EXPECT_EQ(-1, re.EncodeValue(row, row_value));
+
+  // Encode checks the value columns before writing the key.
+  std::string held_key = "held";
+  StringSink key_sink(&held_key);
+  StringSink value_sink(&row_value);
+  EXPECT_EQ(-1, re.Encode('r', row, key_sink, value_sink));
+  EXPECT_EQ("held", held_key);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialListTypeTest, recordEncodeBatch) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+  Row row;
+  ASSERT_EQ(0, rd.Decode(key, value, row));
+
+  // Rows of different widths share the arenas.
+  std::vector<Row> rows(3, row);
+  rows[1].SetString(1, "a longer table name than the first one");
+  rows[2].SetNull(4);
+
+  EncodedBatch batch;
+  ASSERT_EQ(3, re.EncodeBatch('r', rows, batch));
+  ASSERT_EQ(3, batch.Size());
+  EXPECT_EQ(batch.keys.size(), batch.key_offsets.back());
+  EXPECT_EQ(batch.values.size(), batch.value_offsets.back());
+  for (int i = 0; i < 3; i++) {
+    std::string row_key, row_value;
+    ASSERT_EQ(0, re.Encode('r', rows[i], row_key, row_value));
+    EXPECT_EQ(row_key, batch.Key(i));
+    EXPECT_EQ(row_value, batch.Value(i));
+  }
+
+  std::vector<std::vector<std::any>> records(2, *record1);
+  ASSERT_EQ(2, re.EncodeBatch('r', records, batch));
+  EXPECT_EQ(key, batch.Key(1));
+  EXPECT_EQ(value, batch.Value(1));
+
+  // One bad row fails the whole batch.
+  rows[1].SetLong(8, -20);
+  EXPECT_EQ(-1, re.EncodeBatch('r', rows, batch));
+  EXPECT_EQ(0, batch.Size());
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialListTypeTest, recordDecodeColumnBatch) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+  Row row;
+  ASSERT_EQ(0, rd.Decode(key, value, row));
+  std::vector<Row> rows(20, row);
+  for (int i = 0; i < 20; i++) {
+    rows[i].SetInt(0, i);
+    rows[i].SetString(1, std::string(i, 'x'));
+    rows[i].SetLong(9, i * 1000L);
+    if (i % 3 == 0) {
+      rows[i].SetNull(4);
+      rows[i].SetNull(11);
+    }
+    if (i % 4 == 0) {
+      rows[i].SetNull(7);
+      rows[i].SetNull(10);
+    }
+  }
+  EncodedBatch batch;
+  ASSERT_EQ(20, re.EncodeBatch('r', rows, batch));
+
+  std::vector<int> column_indexes;
+  for (int i = 24; i >= 0; i--) {
+    column_indexes.push_back(i);
+  }
+  ColumnBatch columns;
+  ASSERT_EQ(20, rd.DecodeBatch(batch, rd.CreateProjection(column_indexes), columns));
+  ASSERT_EQ(25, columns.columns.size());
+  for (int i = 0; i < 20; i++) {
+    for (int c = 0; c < 25; c++) {
+      const ColumnVector& column = columns.columns[c];
+      int cell = column_indexes[c];
+      ASSERT_EQ(rows[i].IsNull(cell), column.IsNull(i)) << i << " " << cell;
+      if (column.IsNull(i)) {
+        continue;
+      }
+      ASSERT_EQ(rows[i].GetType(cell), column.type);
+      switch (column.type) {
+        case BaseSchema::kBool:
+          EXPECT_EQ(rows[i].GetBool(cell), column.Get<bool>(i));
+          break;
+        case BaseSchema::kInteger:
+          EXPECT_EQ(rows[i].GetInt(cell), column.Get<int32_t>(i));
+          break;
+        case BaseSchema::kFloat:
+          EXPECT_EQ(rows[i].GetFloat(cell), column.Get<float>(i));
+          break;
+        case BaseSchema::kLong:
+          EXPECT_EQ(rows[i].GetLong(cell), column.Get<int64_t>(i));
+          break;
+        case BaseSchema::kDouble:
+          EXPECT_EQ(rows[i].GetDouble(cell), column.Get<double>(i));
+          break;
+        case BaseSchema::kString:
+          EXPECT_EQ(rows[i].GetString(cell), column.GetString(i));
+          break;
+        case BaseSchema::kStringList:
+          ASSERT_EQ(rows[i].GetListSize(cell), column.GetListSize(i));
+          for (int e = 0; e < column.GetListSize(i); e++) {
+            EXPECT_EQ(rows[i].GetStringListElement(cell, e), column.child->GetString(column.GetListOffset(i) + e));
+          }
+          break;
+        case BaseSchema::kLongList:
+          ASSERT_EQ(rows[i].GetListSize(cell), column.GetListSize(i));
+          for (int e = 0; e < column.GetListSize(i); e++) {
+            EXPECT_EQ(rows[i].GetListElement<int64_t>(cell, e),
+                      column.child->Get<int64_t>(column.GetListOffset(i) + e));
+          }
+          break;
+        default:
+          EXPECT_EQ(rows[i].GetListSize(cell), column.GetListSize(i));
+          break;
+      }
+    }
+  }
+  EXPECT_EQ(7, columns.columns[24 - 4].null_count);
+  EXPECT_EQ(5, columns.columns[24 - 10].null_count);
+
+  // Reused for a narrower projection, a column named twice is refused.
+  ASSERT_EQ(20, rd.DecodeBatch(batch, rd.CreateProjection({10, 1}), columns));
+  ASSERT_EQ(2, columns.columns.size());
+  EXPECT_EQ(std::string(19, 'x'), columns.columns[1].GetString(19));
+  EXPECT_EQ(-1, rd.DecodeBatch(batch, rd.CreateProjection({10, 10}), columns));
+  // So is a projection built by a decoder of other schemas.
+  auto few = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(schemas->begin(), schemas->begin() + 3);
+  RecordDecoder other(0, few, 0L, this->le);
+  EXPECT_EQ(-1, other.DecodeBatch(batch, rd.CreateProjection(column_indexes), columns));
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialListTypeTest, recordDecodeArrow) {
+  InitVector();
+  auto schemas = GetSchemas();
+  schemas->at(1)->SetName("name");
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+  std::vector<std::vector<std::any>> records(3, *record1);
+  records[1][8] = optional<int32_t>(-3);
+  records[2][4] = optional<shared_ptr<string>>();
+  EncodedBatch batch;
+  ASSERT_EQ(3, re.EncodeBatch('r', records, batch));
+
+  ArrowSchema schema;
+  ArrowArray array;
+  ASSERT_EQ(0, rd.DecodeArrow(batch, rd.CreateProjection({1, 8, 4, 22}), &schema, &array));
+  EXPECT_STREQ("+s", schema.format);
+  ASSERT_EQ(4, schema.n_children);
+  EXPECT_STREQ("name", schema.children[0]->name);
+  EXPECT_STREQ("8", schema.children[1]->name);
+  EXPECT_STREQ("i", schema.children[1]->format);
+  EXPECT_STREQ("u", schema.children[2]->format);
+  EXPECT_STREQ("+l", schema.children[3]->format);
+  EXPECT_STREQ("l", schema.children[3]->children[0]->format);
+  ASSERT_EQ(3, array.length);
+  ASSERT_EQ(4, array.n_children);
+
+  ArrowArray* ages = array.children[1];
+  EXPECT_EQ(2, ages->n_buffers);
+  EXPECT_EQ(nullptr, ages->buffers[0]);
+  EXPECT_EQ(-3, static_cast<const int32_t*>(ages->buffers[1])[1]);
+
+  ArrowArray* addresses = array.children[2];
+  EXPECT_EQ(3, addresses->n_buffers);
+  EXPECT_EQ(1, addresses->null_count);
+  const auto* offsets = static_cast<const int32_t*>(addresses->buffers[1]);
+  EXPECT_EQ(offsets[2], offsets[3]);
+  EXPECT_EQ(*any_cast<optional<shared_ptr<string>>>((*record1)[4]).value(),
+            std::string(static_cast<const char*>(addresses->buffers[2]) + offsets[0], offsets[1] - offsets[0]));
+
+  ArrowArray* lists = array.children[3];
+  const auto& longs = *any_cast<optional<shared_ptr<vector<int64_t>>>>((*record1)[22]).value();
+  EXPECT_EQ(longs.size(), static_cast<const int32_t*>(lists->buffers[1])[1]);
+  EXPECT_EQ(longs.size() * 3, lists->children[0]->length);
+  EXPECT_EQ(longs[0], static_cast<const int64_t*>(lists->children[0]->buffers[1])[longs.size()]);
+
+  // A child moved out stays valid after the parent is released.
+  ArrowArray moved = *ages;
+  ages->release = nullptr;
+  array.release(&array);
+  EXPECT_EQ(nullptr, array.release);
+  EXPECT_EQ(-3, static_cast<const int32_t*>(moved.buffers[1])[1]);
+  moved.release(&moved);
+  schema.release(&schema);
+  EXPECT_EQ(nullptr, schema.release);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialListTypeTest, recordEncodeColumns) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+  std::vector<std::vector<std::any>> records(30, *record1);
+  for (int i = 0; i < 30; i++) {
+    records[i][0] = optional<int32_t>(i);
+    records[i][1] = optional<shared_ptr<string>>(std::make_shared<string>(i * 3, 'k'));
+    records[i][7] = i % 5 == 0 ? optional<int32_t>() : optional<int32_t>(-i);
+    records[i][21] = i % 4 == 0 ? optional<shared_ptr<vector<int64_t>>>() : (*record1)[22];
+    if (i % 4 == 0) {
+      records[i][4] = optional<shared_ptr<string>>();
+    }
+  }
+  EncodedBatch batch;
+  ASSERT_EQ(30, re.EncodeBatch('r', records, batch));
+
+  // Decoded into columns and encoded back, the keys and values are unchanged.
+  std::vector<int> column_indexes;
+  for (int i = 0; i < 25; i++) {
+    column_indexes.push_back(i);
+  }
+  ColumnBatch columns;
+  ASSERT_EQ(30, rd.DecodeBatch(batch, rd.CreateProjection(column_indexes), columns));
+  EncodedBatch encoded;
+  ASSERT_EQ(30, re.EncodeColumns('r', columns, encoded));
+  EXPECT_EQ(batch.keys, encoded.keys);
+  EXPECT_EQ(batch.values, encoded.values);
+  EXPECT_EQ(batch.key_offsets, encoded.key_offsets);
+  EXPECT_EQ(batch.value_offsets, encoded.value_offsets);
+
+  // Columns out of schema order are refused.
+  ASSERT_EQ(30, rd.DecodeBatch(batch, rd.CreateProjection({1, 0}), columns));
+  EXPECT_EQ(-1, re.EncodeColumns('r', columns, encoded));
+  EXPECT_EQ(0, encoded.Size());
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialListTypeTest, recordBatchOnThreadPool) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+  Row row;
+  ASSERT_EQ(0, rd.Decode(key, value, row));
+  std::vector<Row> rows(1000, row);
+  for (int i = 0; i < 1000; i++) {
+    rows[i].SetLong(3, i);
+    rows[i].SetString(1, std::string(i % 37, 't'));
+  }
+
+  EncodedBatch inline_batch;
+  ASSERT_EQ(1000, re.EncodeBatch('r', rows, inline_batch));
+
+  // Same bytes in the same order, whatever thread encoded a record.
+  auto pool = std::make_shared<ThreadPool>(4);
+  re.SetThreadPool(pool, 16);
+  rd.SetThreadPool(pool, 16);
+  EncodedBatch batch;
+  ASSERT_EQ(1000, re.EncodeBatch('r', rows, batch));
+  EXPECT_EQ(inline_batch.keys, batch.keys);
+  EXPECT_EQ(inline_batch.values, batch.values);
+  EXPECT_EQ(inline_batch.key_offsets, batch.key_offsets);
+
+  std::vector<Row> decoded;
+  ASSERT_EQ(1000, rd.DecodeBatch(batch, decoded));
+  for (int i = 0; i < 1000; i += 99) {
+    EXPECT_EQ(i, decoded[i].GetLong(3));
+    EXPECT_EQ(std::string(i % 37, 't'), decoded[i].GetString(1));
+  }
+
+  std::vector<KeyValue> key_values;
+  for (int i = 0; i < 20; i++) {
+    key_values.emplace_back(std::make_shared<std::string>(batch.Key(i)),
+                            std::make_shared<std::string>(batch.Value(i)));
+  }
+  key_values[7].SetKey(std::make_shared<std::string>("broken"));
+  EXPECT_EQ(-1, rd.DecodeBatch(key_values, decoded));
+
+  rows[500].SetLong(8, -20);
+  EXPECT_EQ(-1, re.EncodeBatch('r', rows, batch));
+  EXPECT_EQ(0, batch.Size());
+
+  // A cell that throws on a worker throws from EncodeBatch, as it does without a pool, and the pool keeps working.
+  std::vector<std::vector<std::any>> records(1000, *record1);
+  records[700][3] = std::string("not a long");
+  EXPECT_THROW(re.EncodeBatch('r', records, batch), std::bad_any_cast);
+  records[700] = *record1;
+  EXPECT_EQ(1000, re.EncodeBatch('r', records, batch));
+  EXPECT_THROW(pool->ParallelFor(100,
+                                 [](int begin, int end) {
+                                   if (begin <= 42 && 42 < end) {
+                                     throw std::runtime_error("range failed");
+                                   }
+                                 }),
+               std::runtime_error);
+
+  // Every index exactly once, also from nested calls.
+  std::vector<std::atomic<int>> hits(5000);
+  pool->ParallelFor(50, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      pool->ParallelFor(100, [&](int inner_begin, int inner_end) {
+        for (int j = inner_begin; j < inner_end; j++) {
+          hits[i * 100 + j]++;
+        }
+      });
+    }
+  });
+  EXPECT_TRUE(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& hit) { return hit == 1; }));
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialListTypeTest, recordCodecsShareSchemas) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  // Reference bytes, each from codecs on their own copy of the schemas.
+  std::string expected_key[2], expected_value[2];
+  for (int le = 0; le < 2; le++) {
+    InitVector();
+    RecordEncoder(0, GetSchemas(), 0L, le).Encode('r', *record1, expected_key[le], expected_value[le]);
+  }
+
+  // Both byte orders on one schema vector, used from several threads at once.
+  const RecordEncoder encoders[2] = {RecordEncoder(0, schemas, 0L, false), RecordEncoder(0, schemas, 0L, true)};
+  const RecordDecoder decoders[2] = {RecordDecoder(0, schemas, 0L, false), RecordDecoder(0, schemas, 0L, true)};
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      int le = t % 2;
+      for (int i = 0; i < 200; i++) {
+        std::string key, value, key2, value2;
+        std::vector<std::any> decoded;
+        if (encoders[le].Encode('r', *record1, key, value) != 0 || key != expected_key[le] ||
+            value != expected_value[le] || decoders[le].Decode(key, value, decoded) != 0 ||
+            encoders[le].Encode('r', decoded, key2, value2) != 0 || key2 != key || value2 != value) {
+          mismatches++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, mismatches);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialListTypeTest, recordLazyDecode) {
+  InitVector();
+  auto schemas = GetSchemas();
+  RecordEncoder re(0, schemas, 0L, this->le);
+  RecordDecoder rd(0, schemas, 0L, this->le);
+  InitRecord();
+  vector<any>* record1 = GetRecord();
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+
+  LazyRecord lazy;
+  ASSERT_EQ(0, rd.Decode(key, value, lazy));
+  ASSERT_EQ(25, lazy.Size());
+  EXPECT_EQ(873485.4234, any_cast<optional<double>>(lazy.Get(10)).value());
+  EXPECT_EQ("tn", *any_cast<optional<shared_ptr<string>>>(lazy.Get(1)).value());
+  EXPECT_FALSE(lazy.IsDecoded(9));
+  EXPECT_FALSE(lazy.IsDecoded(4));
+
+  // Columns walked past and columns beyond the furthest one, in any order.
+  vector<any> columns(25);
+  for (int i : {24, 3, 9, 17, 4, 0, 12, 2, 22, 5, 6, 7, 8, 1, 10, 11, 13, 14, 15, 16, 18, 19, 20, 21, 23}) {
+    columns[i] = lazy.Get(i);
+  }
+  std::string lazy_key, lazy_value;
+  ASSERT_EQ(0, re.Encode('r', columns, lazy_key, lazy_value));
+  EXPECT_EQ(key, lazy_key);
+  EXPECT_EQ(value, lazy_value);
+
+  // Reused for the next row.
+  (*record1)[10] = optional<double>(-1.25);
+  ASSERT_EQ(0, re.Encode('r', *record1, key, value));
+  ASSERT_EQ(0, rd.Decode(key, value, lazy));
+  EXPECT_FALSE(lazy.IsDecoded(10));
+  EXPECT_EQ(-1.25, any_cast<optional<double>>(lazy.Get(10)).value());
+  RecordDecoder other_table(0, schemas, 1L, this->le);
+  EXPECT_EQ(-1, other_table.Decode(key, value, lazy));
+
+  DeleteSchemas();
+  DeleteRecords();
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <serial/record_decoder.h>
+#include <serial/record_encoder.h>
+#include <serial/static_record_codec.h>
+
+#include <any>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace dingodb;
+using namespace std;
+
+using TestKey = Key<Long, String, Nullable<Int>, Nullable<Bool>, Nullable<String>>;
+using TestValue = Value<Int, Nullable<Double>, Float, Nullable<Long>, Nullable<Bool>, Nullable<String>, String>;
+
+class DingoStaticRecordCodecTest : public testing::Test {
+ public:
+  using Record = StaticRecordCodec<TestKey, TestValue>::Record;
+
+  // Same record for the dynamic codec.
+  static vector<any> ToAny(const Record& record) {
+    vector<any> columns(std::tuple_size_v<Record>);
+    auto to_string = [](const auto& str) {
+      return str.has_value() ? optional<shared_ptr<string>>(make_shared<string>(str.value())) : nullopt;
+    };
+    columns[0] = optional<int64_t>(get<0>(record));
+    columns[1] = optional<shared_ptr<string>>(make_shared<string>(get<1>(record)));
+    columns[2] = get<2>(record);
+    columns[3] = get<3>(record);
+    columns[4] = to_string(get<4>(record));
+    columns[5] = optional<int32_t>(get<5>(record));
+    columns[6] = get<6>(record);
+    columns[7] = optional<float>(get<7>(record));
+    columns[8] = get<8>(record);
+    columns[9] = get<9>(record);
+    columns[10] = to_string(get<10>(record));
+    columns[11] = optional<shared_ptr<string>>(make_shared<string>(get<11>(record)));
+    return columns;
+  }
+
+  template <bool LE>
+  static void CheckEquivalence(const Record& record) {
+    StaticRecordCodec<TestKey, TestValue, LE> codec(3, 1001);
+    auto schemas = StaticRecordCodec<TestKey, TestValue, LE>::CreateSchemas();
+    RecordEncoder re(3, schemas, 1001, LE);
+    RecordDecoder rd(3, schemas, 1001, LE);
+
+    string key, value;
+    ASSERT_EQ(0, codec.Encode('r', record, key, value));
+    EXPECT_EQ(key.size(), codec.EncodedKeySize(record));
+    EXPECT_EQ(value.size(), codec.EncodedValueSize(record));
+
+    string expected_key, expected_value;
+    ASSERT_EQ(0, re.Encode('r', ToAny(record), expected_key, expected_value));
+    EXPECT_EQ(expected_key, key);
+    EXPECT_EQ(expected_value, value);
+
+    Record decoded;
+    ASSERT_EQ(0, codec.Decode(expected_key, expected_value, decoded));
+    EXPECT_EQ(record, decoded);
+
+    vector<any> columns;
+    ASSERT_EQ(0, rd.Decode(key, value, columns));
+    EXPECT_EQ(get<1>(record), *any_cast<optional<shared_ptr<string>>>(columns[1]).value());
+    EXPECT_EQ(get<8>(record), any_cast<optional<int64_t>>(columns[8]));
+  }
+};
+
+TEST_F(DingoStaticRecordCodecTest, matchesDynamicCodec) {
+  Record record{-214748364700L,
+                "static codec key longer than a group",
+                7,
+                true,
+                string("中文"),
+                -20,
+                873485.4234,
+                -1.5f,
+                214748364700L,
+                false,
+                string(),
+                "value"};
+  CheckEquivalence<true>(record);
+  CheckEquivalence<false>(record);
+
+  Record nulls{0, "", nullopt, nullopt, nullopt, 0, nullopt, 2.25f, nullopt, nullopt, nullopt, "12345678"};
+  CheckEquivalence<true>(nulls);
+  CheckEquivalence<false>(nulls);
+}
+
+TEST_F(DingoStaticRecordCodecTest, structThroughTie) {
+  struct Account {
+    int64_t id;
+    string name;
+    optional<double> balance;
+  } account{42, "alice", 12.5};
+
+  StaticRecordCodec<Key<Long>, Value<String, Nullable<Double>>> codec(1, 7);
+  string key, value;
+  ASSERT_EQ(0, codec.Encode('r', std::tie(account.id, account.name, account.balance), key, value));
+
+  Account decoded{};
+  ASSERT_EQ(0, codec.Decode(key, value, std::tie(decoded.id, decoded.name, decoded.balance)));
+  EXPECT_EQ(42, decoded.id);
+  EXPECT_EQ("alice", decoded.name);
+  EXPECT_EQ(12.5, decoded.balance.value());
+
+  // Other table.
+  StaticRecordCodec<Key<Long>, Value<String, Nullable<Double>>> other(1, 8);
+  EXPECT_EQ(-1, other.Decode(key, value, std::tie(decoded.id, decoded.name, decoded.balance)));
+
+  // |schema version|string length|... a length past the end of the value, a value cut inside the double.
+  string corrupt = value;
+  corrupt.replace(4, 4, string(4, '\x7f'));
+  EXPECT_EQ(-1, codec.Decode(key, corrupt, std::tie(decoded.id, decoded.name, decoded.balance)));
+  string cut = value.substr(0, value.size() - 1);
+  EXPECT_EQ(-1, codec.Decode(key, cut, std::tie(decoded.id, decoded.name, decoded.balance)));
+}